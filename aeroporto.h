@@ -0,0 +1,179 @@
+// libaeroporto: simulação de tráfego aéreo embutível (API C)
+//
+// O mesmo aeroporto.c gera o programa de linha de comando e a biblioteca. Com
+// -DAEROPORTO_BIBLIOTECA o main() fica de fora:
+//
+//   gcc -O2 -pthread -fPIC -fvisibility=hidden -DAEROPORTO_BIBLIOTECA -c aeroporto.c -o aeroporto.o
+//   ar rcs libaeroporto.a aeroporto.o                          (estática)
+//   gcc -shared -pthread -o libaeroporto.so aeroporto.o -lm    (compartilhada: exporta só a API)
+//
+// Uso típico:
+//
+//   aeroporto_config_t config;
+//   aeroporto_config_padrao(&config);
+//   config.pistas = 4;
+//   aeroporto_t* sim = aeroporto_criar(&config);
+//   aeroporto_executar_ate(sim, 60.0);        // Avança até t = 60 s simulados
+//   aeroporto_estatisticas(sim, &estatisticas);
+//   aeroporto_executar(sim);                  // Até o último avião encerrar
+//   aeroporto_destruir(sim);
+//
+// A simulação é multithread e corre em tempo real escalado por config.aceleracao: entre duas
+// chamadas ela continua avançando, e as consultas devolvem cópias consistentes do instante em que
+// foram feitas. O estado do simulador é global, então há no máximo uma simulação por processo de
+// cada vez (aeroporto_criar devolve NULL enquanto outra não for destruída); simulações seguidas no
+// mesmo processo são independentes.
+
+#ifndef AEROPORTO_H
+#define AEROPORTO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AEROPORTO_API __attribute__((visibility("default")))
+#define AEROPORTO_API_VERSAO 4
+
+typedef struct aeroporto aeroporto_t;
+
+// Estados de um avião (aeroporto_aviao_t.estado, aeroporto_evento_t.estado)
+typedef enum {
+    AEROPORTO_ESPERANDO_POUSO,
+    AEROPORTO_POUSANDO,
+    AEROPORTO_ESPERANDO_DESEMBARQUE,
+    AEROPORTO_DESEMBARCANDO,
+    AEROPORTO_ESPERANDO_DECOLAGEM,
+    AEROPORTO_DECOLANDO,
+    AEROPORTO_FINALIZADO,
+    AEROPORTO_CRASHED,
+    AEROPORTO_DESVIADO
+} aeroporto_estado_t;
+
+// Recursos nativos (índices da máscara de recursos retidos); tipos extras vêm depois deles
+typedef enum {
+    AEROPORTO_RECURSO_PISTA,
+    AEROPORTO_RECURSO_PORTAO,
+    AEROPORTO_RECURSO_TORRE
+} aeroporto_recurso_t;
+
+typedef enum {
+    AEROPORTO_EVENTO_ESTADO,      // Mudança de estado
+    AEROPORTO_EVENTO_ESPERA,      // Começou a aguardar um recurso
+    AEROPORTO_EVENTO_VERIFICACAO, // Ainda aguardando (valor = espera até aqui)
+    AEROPORTO_EVENTO_CONCESSAO,   // Recurso obtido (valor = espera)
+    AEROPORTO_EVENTO_LIBERACAO,   // Recurso devolvido
+    AEROPORTO_EVENTO_DESVIO,
+    AEROPORTO_EVENTO_CRASH        // valor = espera no momento do crash
+} aeroporto_tipo_evento_t;
+
+typedef struct {
+    int pistas;                 // 1-10
+    int portoes;                // 1-15
+    int torre;                  // Operações simultâneas na torre, 1-5
+    int tempo_simulacao;        // Segundos simulados de criação de aviões, 30-600
+    double aceleracao;          // Segundos simulados por segundo real, 1-1000
+    uint64_t semente;           // 0 = relógio (com snapshot, 0 mantém os fluxos gravados)
+    int holding;                // Vagas do circuito de espera, 1-50
+    int controle_admissao;      // Medição de chegadas e desvios no lugar de crashes (padrão 0)
+    int prioridade_edf;         // Faixa de urgência por combustível, menor prazo primeiro (padrão 0)
+    int heranca_prioridade;     // Detentores bloqueados herdam a prioridade de quem os aguarda (padrão 0)
+    int turnaround;             // Limpeza, abastecimento e embarque no portão antes da decolagem (padrão 0)
+    int posicoes_remotas;       // 0-20
+    int caminhoes_combustivel;  // 0 = abastecimento não modelado
+    int balcoes_imigracao;      // 1-64
+    int modelo_passageiros;     // Desembarque passageiro a passageiro pelo terminal (padrão 0: duração fixa)
+    const char* malha_taxi;     // Layout da malha de taxiamento ou NULL
+    const char* snapshot;       // Snapshot para warm start ou NULL
+    int silencioso;             // Suprime as mensagens por evento no stdout
+} aeroporto_config_t;
+
+typedef struct {
+    double relogio;                  // Segundos simulados desde o início
+    int concluida;                   // Criação encerrada e nenhum avião ativo
+    int avioes_criados;
+    int avioes_ativos;
+    int finalizados;
+    int crashed;
+    int desviados;
+    int pousos;
+    int decolagens;
+    int desembarques;
+    int passageiros_desembarcados;
+    double tempo_medio_ciclo;        // s, aviões finalizados
+    double espera_media_recurso;     // s por aquisição
+    double espera_p99_recurso;
+    double espera_maxima_recurso;
+    int pistas_em_uso;
+    int portoes_em_uso;
+    int torre_em_uso;
+    int holding_ocupacao;
+} aeroporto_estatisticas_t;
+
+typedef struct {
+    int id;
+    int internacional;          // 0 = doméstico
+    int categoria;              // Esteira: 0 leve, 1 média, 2 pesada
+    int estado;                 // aeroporto_estado_t
+    unsigned recursos_detidos;  // Máscara (1 << aeroporto_recurso_t)
+    int recurso_aguardado;      // aeroporto_recurso_t ou -1
+    double espera;              // s simulados na espera atual
+    double combustivel;         // s simulados de autonomia restante
+} aeroporto_aviao_t;
+
+typedef struct {
+    int aviao;                  // Id do avião
+    int tipo;                   // aeroporto_tipo_evento_t
+    int recurso;                // aeroporto_recurso_t ou -1
+    int estado;                 // Estado do avião no evento
+    double valor;
+    double instante;            // s simulados
+} aeroporto_evento_t;
+
+// Chamado em qualquer thread do simulador (aviões, criador, monitores), inclusive por várias ao
+// mesmo tempo e possivelmente com travas internas retidas: deve ser thread-safe e rápido, e não
+// pode chamar funções desta API
+typedef void (*aeroporto_callback_t)(const aeroporto_evento_t* evento, void* contexto);
+
+AEROPORTO_API void aeroporto_config_padrao(aeroporto_config_t* config);
+
+// Valida a configuração e prepara recursos, estatísticas e fluxos aleatórios. NULL em erro ou se
+// já houver uma simulação ativa no processo; aeroporto_erro() diz o motivo.
+AEROPORTO_API aeroporto_t* aeroporto_criar(const aeroporto_config_t* config);
+
+// Motivo (texto sem cores) da última falha de aeroporto_criar ou ao iniciar a execução; "" se a
+// última aeroporto_criar teve sucesso. A biblioteca não imprime erros nem encerra o processo.
+AEROPORTO_API const char* aeroporto_erro(void);
+
+// Registra (ou remove, com NULL) o callback de eventos; chamar antes de executar
+AEROPORTO_API void aeroporto_registrar_callback(aeroporto_t* sim, aeroporto_callback_t callback, void* contexto);
+
+// Inicia a simulação, se preciso, e bloqueia até o relógio chegar a 'instante' segundos simulados
+// ou a simulação terminar. Retorna 1 se ela terminou, 0 caso contrário e -1 se não pôde iniciar.
+AEROPORTO_API int aeroporto_executar_ate(aeroporto_t* sim, double instante);
+
+// Executa até a criação encerrar e o último avião terminar. Retorna -1 se não pôde iniciar.
+AEROPORTO_API int aeroporto_executar(aeroporto_t* sim);
+
+AEROPORTO_API double aeroporto_relogio(const aeroporto_t* sim);
+AEROPORTO_API void aeroporto_estatisticas(aeroporto_t* sim, aeroporto_estatisticas_t* estatisticas);
+AEROPORTO_API int aeroporto_num_avioes(aeroporto_t* sim);
+
+// Cópia consistente do avião de índice 0..aeroporto_num_avioes()-1. Retorna -1 fora do intervalo.
+AEROPORTO_API int aeroporto_aviao(aeroporto_t* sim, int indice, aeroporto_aviao_t* aviao);
+
+// Muda ao vivo a capacidade de um recurso (aeroporto_recurso_t ou índice de um tipo extra). Uma
+// redução não revoga concessões: o excedente é drenado conforme os detentores devolvem. Pistas e
+// portões vão de 0 ao configurado; a torre até 5. Retorna -1 fora desses limites. A configuração
+// volta a valer quando a rodada termina.
+AEROPORTO_API int aeroporto_alterar_capacidade(aeroporto_t* sim, int recurso, int capacidade);
+
+// Encerra a criação de aviões, aguarda os ativos e libera os recursos da simulação
+AEROPORTO_API void aeroporto_destruir(aeroporto_t* sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
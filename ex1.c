@@ -14,46 +14,166 @@
 // Pergunta a ser respondida: 
 // Determine a quantidade de threads ideal para o seu problema (a partir de determinada quantidade, o tempo não irá reduzir, podendo até piorar. Faz sentido? qual motivo?)?
 
+// Implementação: em vez de somar numa variável compartilhada protegida por mutex, cada thread escreve
+// sua soma parcial numa posição própria, alinhada em linha de cache (sem disputa nem falso compartilhamento),
+// e as parciais são combinadas em árvore: a cada nível, metade das threads soma a parcial da vizinha.
+// O mutex vira desnecessário e o tempo de combinação cresce com log2(threads) em vez de linearmente.
+//
+// Para responder à pergunta sem rodar tentativas à mão: "./ex1 bench [-o sum|mix] [-t max_threads] [-s max_size]"
+// varre tamanhos de vetor e números de threads, mede GB/s contra o teto de banda de memória (roofline) e
+// aponta o joelho -- a menor quantidade de threads a 5% do melhor tempo. O joelho de cada tamanho fica
+// salvo em TUNING_FILE; no modo interativo, digitar 0 threads usa o valor ajustado para o tamanho mais próximo.
+//
+// A divisão estática em blocos iguais só funciona se todo elemento custa o mesmo. Por padrão a redução roda
+// sobre um escalonador com roubo de trabalho: cada thread começa com o seu bloco numa deque própria, divide
+// ao meio a tarefa corrente quando alguém está sem trabalho, e threads ociosas roubam da ponta oposta de
+// deques escolhidas ao acaso. "-o skew" no benchmark usa um custo por elemento que cresce com o valor.
+
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h> 
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define CACHE_LINE 64
+
+#define TUNING_FILE ".ex1_tuning"                                    // Linhas "operação tamanho threads"
+#define MAX_TUNING_ENTRIES 64
+#define BENCH_REPEATS 3                                              // Melhor de N execuções por configuração
+#define BENCH_DEFAULT_MAX_SIZE (1L << 25)                           // 256 MB de longs
+#define KNEE_TOLERANCE 1.05                                          // Joelho: menor contagem a 5% do melhor tempo
+#define MIN_THREADS 2                                                // Mínimo do enunciado, também para o joelho salvo
+#define MIX_ROUNDS 16                                                // Custo da operação "mix" por elemento
+#define SKEW_MAX_ROUNDS 256                                          // Custo máximo da operação "skew" (último elemento)
+
+#define DEQUE_CAPACITY 64                                            // Tarefas pendentes por thread
+#define MIN_GRAIN 4096                                               // Abaixo disso não vale dividir uma tarefa
+#define TASKS_PER_THREAD 64                                          // Grão alvo: size / (threads * TASKS_PER_THREAD)
+
+typedef long (*reduce_kernel_t)(const long *data, long count, long length); // Reduz data[0..count-1]; length: tamanho do vetor todo
+
+typedef enum {
+    SCHEDULE_STATIC,                                                 // Um bloco fixo por thread
+    SCHEDULE_STEALING                                                // Blocos iniciais + divisão e roubo sob demanda
+} schedule_t;
+
+typedef struct {
+    long begin;
+    long end;                                                        // Exclusivo
+} task_t;
+
+// Deque de uma thread: o dono empilha e desempilha em "bottom", ladrões retiram de "top" (as tarefas mais
+// antigas, que são as maiores). Um mutex por deque basta: o dono quase nunca disputa com ladrões.
+typedef struct {
+    _Alignas(CACHE_LINE) pthread_mutex_t lock;
+    task_t tasks[DEQUE_CAPACITY];
+    int top;
+    int bottom;
+} task_deque_t;
+
+typedef struct {
+    _Alignas(CACHE_LINE) long value;                                 // Uma parcial por linha de cache
+} padded_partial_t;
+
+typedef struct {
+    const long *data;
+    long size;
+    int num_threads;
+    reduce_kernel_t kernel;
+    padded_partial_t *partials;
+    pthread_barrier_t barrier;                                       // Separa os níveis da árvore de combinação
+    schedule_t schedule;
+    task_deque_t *deques;                                            // Uma por thread (SCHEDULE_STEALING)
+    long grain;
+    _Alignas(CACHE_LINE) atomic_long remaining;                      // Elementos ainda não reduzidos
+    atomic_int idle;                                                 // Threads procurando trabalho
+} reduce_job_t;
+
+typedef struct {
+    reduce_job_t *job;
+    long thread_id;
+    long start_index;
+    long end_index;
+    long local_sum;                                                  // Parcial antes da combinação (para o relatório)
+    long elements;                                                   // Elementos reduzidos por esta thread
+    long steals;                                                     // Tarefas roubadas de outras threads
+    unsigned long rng;                                               // Escolha de vítimas
+} reduce_worker_t;
+
+typedef struct {
+    long *data;
+    long size;
+    int num_threads;
+    long thread_id;
+} fill_worker_t;
+
+typedef struct {
+    const char *name;
+    reduce_kernel_t kernel;                                          // NULL: escolhido em tempo de execução (sum)
+} reduce_op_t;
+
+typedef struct {
+    char op[16];
+    long size;
+    int threads;
+} tuning_entry_t;
 
 long *handle_input();
 long *initialize_vector(long size);
+void *fill_routine(void *arg);
 void *sum_routine(void *arg);
+long parallel_reduce(const long *data, long size, int threads, reduce_kernel_t kernel, schedule_t schedule,
+                     reduce_worker_t *workers);
+reduce_kernel_t select_sum_kernel(void);
+void chunk_bounds(long size, int threads, long thread_id, long *start_index, long *end_index);
+void pin_to_core(long thread_id);
+int run_benchmark(int argc, char *argv[]);
+reduce_op_t *find_op(const char *name);
+int load_tuned_threads(const char *op, long size);
+void save_tuned_threads(const char *op, long size, int threads);
 
 long *vector;
 long vector_size;
 int num_threads;
-long total_sum = 0; 
-pthread_mutex_t mutex;
 
-int main()
+int main(int argc, char *argv[])
 {   
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {                                        // Modo de varredura automática
+        return run_benchmark(argc - 1, argv + 1);
+    }
+
     long *inputs_array = handle_input();                                                    // Recebe os inputs do usuário: tamanho do vetor e número de threads
     vector_size = inputs_array[0];                                                           
     num_threads = (int)inputs_array[1];        
 
     free(inputs_array);                                                                     // Libera a memória alocada para os inputs
 
-    vector = initialize_vector(vector_size);                                                // Inicializa o vetor com valores de 1 a vector_size
-    pthread_mutex_init(&mutex, NULL);                                                       // Inicializa o mutex
-    pthread_t *threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));              // Aloca memória para os identificadores das threads
-
-    for (long i = 0; i < num_threads; i++) {                                                // Cria as threads
-        pthread_create(&threads[i], NULL, sum_routine, (void *)i);
+    vector = initialize_vector(vector_size);                                                // Inicializa o vetor com valores de 0 a vector_size-1, em paralelo
+    reduce_worker_t *workers = (reduce_worker_t *)malloc(num_threads * sizeof(reduce_worker_t)); // Parciais de cada thread, para o relatório
+    if (workers == NULL) {
+        perror("Failed to allocate memory for workers");
+        exit(EXIT_FAILURE);
     }
 
-    for (int i = 0; i < num_threads; i++) {                                                 // Aguarda a finalização de todas as threads
-        pthread_join(threads[i], NULL);
+    long total_sum = parallel_reduce(vector, vector_size, num_threads, select_sum_kernel(), SCHEDULE_STEALING, workers);
+
+    for (int i = 0; i < num_threads; i++) {                                                 // Relatório fora de qualquer seção crítica
+        printf("Thread %ld: Calculated local sum of %ld elements (initial block %ld to %ld, %ld stolen tasks): %ld\n",
+               workers[i].thread_id, workers[i].elements, workers[i].start_index, workers[i].end_index,
+               workers[i].steals, workers[i].local_sum);
     }
     printf("%ld\n", total_sum);                                                             // Imprime o resultado da soma total
 
-    pthread_mutex_destroy(&mutex);                                                          // Destrói o mutex
     free(vector);                                                                           // Libera a memória alocada para o vetor
-    free(threads);                                                                          // Libera a memória alocada para os identificadores das threads
+    free(workers);                                                                          // Libera a memória alocada para as parciais
 
     return 0;
 
@@ -79,9 +199,17 @@ long *handle_input()
         exit(EXIT_FAILURE);
     }
 
-    printf("Type the number of threads (>= 2): ");
+    printf("Type the number of threads (>= 2, 0 = tuned): ");
     scanf("%d", &num_threads_temp);
-    if (num_threads_temp < 2) {
+    if (num_threads_temp == 0) {                                    // Usa o joelho medido por "./ex1 bench"
+        num_threads_temp = load_tuned_threads("sum", vector_size_temp);
+        if (num_threads_temp == 0) {
+            printf("No tuned thread count in %s; run \"./ex1 bench\" first.\n", TUNING_FILE);
+            free(inputs);
+            exit(EXIT_FAILURE);
+        }
+        printf("Using tuned thread count: %d\n", num_threads_temp);
+    } else if (num_threads_temp < MIN_THREADS) {
         printf("The number of threads must be at least 2.\n");
         free(inputs);
         exit(EXIT_FAILURE);
@@ -93,6 +221,33 @@ long *handle_input()
     return inputs; 
 }
 
+// Divide [0, size) em blocos que diferem em no máximo um elemento -> 100 itens, 3 threads: 33, 33, 34
+void chunk_bounds(long size, int threads, long thread_id, long *start_index, long *end_index) {
+    *start_index = size * thread_id / threads;
+    *end_index = size * (thread_id + 1) / threads - 1;
+}
+
+// Fixa a thread no (thread_id % n)-ésimo núcleo permitido ao processo; se falhar, segue sem afinidade
+void pin_to_core(long thread_id) {
+    cpu_set_t allowed, target;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+
+    int cores = CPU_COUNT(&allowed);
+    long wanted = thread_id % cores;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && wanted-- == 0) {
+            CPU_ZERO(&target);
+            CPU_SET(cpu, &target);
+            pthread_setaffinity_np(pthread_self(), sizeof(target), &target);
+            return;
+        }
+    }
+}
+
+// O vetor é escrito pelas mesmas threads (e núcleos) que depois vão lê-lo: a primeira escrita de cada
+// página acontece em paralelo, e em máquinas NUMA a página fica no nó de quem vai somá-la
 long *initialize_vector(long size) {
     long *temp_vector = malloc(size * sizeof(long)); 
     if (temp_vector == NULL) {
@@ -100,36 +255,533 @@ long *initialize_vector(long size) {
         exit(EXIT_FAILURE);
     }
 
-    for (long i = 0; i < size; i++) {
-        temp_vector[i] = i ;
+    pthread_t *threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    fill_worker_t *workers = (fill_worker_t *)malloc(num_threads * sizeof(fill_worker_t));
+    if (threads == NULL || workers == NULL) {
+        perror("Failed to allocate memory for fill threads");
+        exit(EXIT_FAILURE);
     }
 
+    for (long i = 0; i < num_threads; i++) {
+        workers[i] = (fill_worker_t){ temp_vector, size, num_threads, i };
+        pthread_create(&threads[i], NULL, fill_routine, &workers[i]);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    free(workers);
     return temp_vector;
 }
 
+void *fill_routine(void *arg) {
+    fill_worker_t *worker = (fill_worker_t *)arg;
+    long start_index, end_index;
+
+    pin_to_core(worker->thread_id);
+    chunk_bounds(worker->size, worker->num_threads, worker->thread_id, &start_index, &end_index);
+    for (long i = start_index; i <= end_index; i++) {
+        worker->data[i] = i;
+    }
+
+    return NULL;
+}
+
+// ========== KERNELS DE SOMA ==========
+
+static long sum_scalar(const long *data, long count, long length) {
+    (void)length;
+    long sum = 0;
+    for (long i = 0; i < count; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Dois acumuladores independentes escondem a latência da soma; a sobra (< 8 itens) vai no escalar
+__attribute__((target("avx2")))
+static long sum_avx2(const long *data, long count, long length) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    long i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256((const __m256i *)(data + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256((const __m256i *)(data + i + 4)));
+    }
+
+    long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_scalar(data + i, count - i, length);
+}
+
+__attribute__((target("avx512f")))
+static long sum_avx512(const long *data, long count, long length) {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    long i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm512_add_epi64(acc0, _mm512_loadu_si512((const void *)(data + i)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_loadu_si512((const void *)(data + i + 8)));
+    }
+
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(acc0, acc1)) + sum_scalar(data + i, count - i, length);
+}
+#endif
+
+// Escolhe o kernel mais largo suportado pela CPU em tempo de execução
+reduce_kernel_t select_sum_kernel(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return sum_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return sum_avx2;
+    }
+#endif
+    return sum_scalar;
+}
+
+// ========== REDUÇÃO PARALELA ==========
+
+// Reduz data[0..size-1] com "threads" threads usando "kernel" em cada bloco e soma como combinação.
+// Se workers != NULL, recebe o bloco inicial, a parcial e as estatísticas de cada thread.
+long parallel_reduce(const long *data, long size, int threads, reduce_kernel_t kernel, schedule_t schedule,
+                     reduce_worker_t *workers) {
+    reduce_job_t job = { .data = data, .size = size, .num_threads = threads, .kernel = kernel, .schedule = schedule };
+    pthread_t *handles = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    reduce_worker_t *own_workers = NULL;
+
+    job.partials = (padded_partial_t *)aligned_alloc(CACHE_LINE, threads * sizeof(padded_partial_t));
+    job.deques = (task_deque_t *)aligned_alloc(CACHE_LINE, threads * sizeof(task_deque_t));
+    if (workers == NULL) {
+        workers = own_workers = (reduce_worker_t *)malloc(threads * sizeof(reduce_worker_t));
+    }
+    if (handles == NULL || job.partials == NULL || job.deques == NULL || workers == NULL) {
+        perror("Failed to allocate memory for reduction");
+        exit(EXIT_FAILURE);
+    }
+    pthread_barrier_init(&job.barrier, NULL, threads);
+    job.grain = size / ((long)threads * TASKS_PER_THREAD);
+    if (job.grain < MIN_GRAIN) {
+        job.grain = MIN_GRAIN;
+    }
+    atomic_init(&job.remaining, size);
+    atomic_init(&job.idle, 0);
+
+    for (long i = 0; i < threads; i++) {                                // Bloco inicial de cada thread na sua deque
+        long start_index, end_index;
+        chunk_bounds(size, threads, i, &start_index, &end_index);
+        pthread_mutex_init(&job.deques[i].lock, NULL);
+        job.deques[i].tasks[0] = (task_t){ start_index, end_index + 1 };
+        job.deques[i].top = 0;
+        job.deques[i].bottom = start_index <= end_index ? 1 : 0;
+    }
+
+    for (long i = 0; i < threads; i++) {                                // Cria as threads
+        workers[i].job = &job;
+        workers[i].thread_id = i;
+        workers[i].rng = 0x9E3779B97F4A7C15UL * (i + 1);
+        pthread_create(&handles[i], NULL, sum_routine, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) {                                 // Aguarda a finalização de todas as threads
+        pthread_join(handles[i], NULL);
+    }
+
+    long total = job.partials[0].value;                                 // A raiz da árvore acumulou tudo
+
+    pthread_barrier_destroy(&job.barrier);
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&job.deques[i].lock);
+    }
+    free(job.deques);
+    free(job.partials);
+    free(handles);
+    free(own_workers);
+    return total;
+}
+
+// ========== ROUBO DE TRABALHO ==========
+
+static int deque_push(task_deque_t *deque, task_t task) {
+    int pushed = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->top == deque->bottom) {                                  // Vazia: recomeça do início do vetor
+        deque->top = deque->bottom = 0;
+    }
+    if (deque->bottom < DEQUE_CAPACITY) {
+        deque->tasks[deque->bottom++] = task;
+        pushed = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return pushed;
+}
+
+static int deque_pop(task_deque_t *deque, task_t *task) {
+    int popped = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        *task = deque->tasks[--deque->bottom];
+        popped = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return popped;
+}
+
+static int deque_steal(task_deque_t *deque, task_t *task) {
+    int stolen = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) {
+        *task = deque->tasks[deque->top++];
+        stolen = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return stolen;
+}
+
+static int deque_is_empty(task_deque_t *deque) {
+    pthread_mutex_lock(&deque->lock);
+    int empty = deque->bottom == deque->top;
+    pthread_mutex_unlock(&deque->lock);
+    return empty;
+}
+
+// Percorre as outras deques a partir de uma vítima aleatória (xorshift por thread)
+static int steal_task(reduce_worker_t *worker, task_t *task) {
+    reduce_job_t *job = worker->job;
+    int threads = job->num_threads;
+
+    worker->rng ^= worker->rng << 13;
+    worker->rng ^= worker->rng >> 7;
+    worker->rng ^= worker->rng << 17;
+    for (int i = 0; i < threads; i++) {
+        long victim = (long)((worker->rng + i) % threads);
+        if (victim != worker->thread_id && deque_steal(&job->deques[victim], task)) {
+            worker->steals++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Reduz uma tarefa. Divisão adaptativa: enquanto a tarefa for maior que o grão e houver demanda (alguém
+// ocioso ou a própria deque vazia, isto é, nada para roubar daqui), a metade de cima vai para a deque;
+// sem demanda, processa um grão por vez e volta a olhar. Assim as tarefas só ficam pequenas quando preciso.
+static long run_task(reduce_worker_t *worker, task_t task) {
+    reduce_job_t *job = worker->job;
+    task_deque_t *deque = &job->deques[worker->thread_id];
+    long sum = 0;
+
+    while (task.end - task.begin > job->grain) {
+        if (atomic_load_explicit(&job->idle, memory_order_relaxed) > 0 || deque_is_empty(deque)) {
+            long middle = task.begin + (task.end - task.begin) / 2;
+            if (deque_push(deque, (task_t){ middle, task.end })) {
+                task.end = middle;
+                continue;
+            }
+        }
+        sum += job->kernel(job->data + task.begin, job->grain, job->size);
+        atomic_fetch_sub_explicit(&job->remaining, job->grain, memory_order_relaxed);
+        worker->elements += job->grain;
+        task.begin += job->grain;
+    }
+
+    sum += job->kernel(job->data + task.begin, task.end - task.begin, job->size);
+    atomic_fetch_sub_explicit(&job->remaining, task.end - task.begin, memory_order_relaxed);
+    worker->elements += task.end - task.begin;
+    return sum;
+}
+
+static long run_stealing(reduce_worker_t *worker) {
+    reduce_job_t *job = worker->job;
+    task_deque_t *deque = &job->deques[worker->thread_id];
+    int is_idle = 0;
+    long sum = 0;
+    task_t task;
+
+    while (atomic_load_explicit(&job->remaining, memory_order_relaxed) > 0) {
+        if (deque_pop(deque, &task) || steal_task(worker, &task)) {
+            if (is_idle) {
+                atomic_fetch_sub(&job->idle, 1);
+                is_idle = 0;
+            }
+            sum += run_task(worker, task);
+        } else {
+            if (!is_idle) {
+                atomic_fetch_add(&job->idle, 1);
+                is_idle = 1;
+            }
+            sched_yield();                                              // Tudo já foi distribuído; espera o fim
+        }
+    }
+    if (is_idle) {
+        atomic_fetch_sub(&job->idle, 1);
+    }
+    return sum;
+}
+
 void *sum_routine(void *arg) {
-    long thread_id = (long)arg;                                     // ID da thread
-    long local_sum = 0;
+    reduce_worker_t *worker = (reduce_worker_t *)arg;
+    reduce_job_t *job = worker->job;
+    long thread_id = worker->thread_id;                                 // ID da thread
 
-    long chunk_size = vector_size / num_threads;                    // Tamanho do chunk para cada thread -> SE VECTOR_SIZE = 100 e NUM_THREADS = 2, então CHUNK_SIZE = 50
-    long remaining_items = vector_size % num_threads;               // Itens restantes que não se dividem igualmente entre as threads
+    pin_to_core(thread_id);
+    chunk_bounds(job->size, job->num_threads, thread_id, &worker->start_index, &worker->end_index);
+    worker->elements = 0;
+    worker->steals = 0;
 
-    long start_index = thread_id * chunk_size;                      // Index inicial para esta thread -> SE THREAD 0, START_INDEX = 0; SE THREAD 1, START_INDEX = 50
-    if (thread_id == num_threads - 1)                               // Se for a última thread, ela pega os itens restantes
-    {                                                                       
-        chunk_size += remaining_items;                              // A última thread pega o restante dos itens
+    if (job->schedule == SCHEDULE_STEALING) {
+        worker->local_sum = run_stealing(worker);
+    } else {
+        worker->local_sum = job->kernel(job->data + worker->start_index,   // Soma os elementos da sua parte do vetor
+                                        worker->end_index - worker->start_index + 1, job->size);
+        worker->elements = worker->end_index - worker->start_index + 1;
     }
-    long end_index = start_index + chunk_size - 1;                  // Index final para esta thread -> SE THREAD 0, END_INDEX = 49; SE THREAD 1, END_INDEX = 99
+    job->partials[thread_id].value = worker->local_sum;
 
-    
-    for (long i = start_index; i <= end_index; i++) {                // Soma os elementos da sua parte do vetor
-        local_sum += vector[i];
+    // Combinação em árvore: no nível "stride", a thread múltipla de 2*stride soma a parcial da thread id+stride
+    for (long stride = 1; stride < job->num_threads; stride *= 2) {
+        pthread_barrier_wait(&job->barrier);
+        if (thread_id % (2 * stride) == 0 && thread_id + stride < job->num_threads) {
+            job->partials[thread_id].value += job->partials[thread_id + stride].value;
+        }
     }
 
-    pthread_mutex_lock(&mutex);
-    printf("Thread %ld: Calculated local sum from index %ld to %ld: %ld\n", thread_id, start_index, end_index, local_sum);
-    total_sum += local_sum;
-    pthread_mutex_unlock(&mutex);
+    return NULL;
+}
+
+// ========== BENCHMARK E AUTO-AJUSTE ==========
+
+// Operação mais pesada que a soma, como sugere o exercício: MIX_ROUNDS rodadas de um gerador congruencial
+// por elemento. Com ~16 multiplicações por 8 bytes lidos ela deixa de ser limitada pela memória.
+static long mix_kernel(const long *data, long count, long length) {
+    (void)length;
+    long sum = 0;
+    for (long i = 0; i < count; i++) {
+        unsigned long h = (unsigned long)data[i];
+        for (int r = 0; r < MIX_ROUNDS; r++) {
+            h = h * 6364136223846793005UL + 1442695040888963407UL;
+            h ^= h >> 29;
+        }
+        sum += (long)(h & 0xffff);
+    }
+    return sum;
+}
+
+// Custo que cresce com o valor (x^4 ao longo do vetor): com divisão estática o último bloco concentra quase
+// metade do trabalho. Normaliza pelo tamanho do vetor todo, não do bloco recebido.
+static long skew_kernel(const long *data, long count, long length) {
+    long sum = 0;
+    for (long i = 0; i < count; i++) {
+        double x = (double)data[i] / length;
+        int rounds = 1 + (int)(SKEW_MAX_ROUNDS * x * x * x * x);
+        unsigned long h = (unsigned long)data[i];
+        for (int r = 0; r < rounds; r++) {
+            h = h * 6364136223846793005UL + 1442695040888963407UL;
+            h ^= h >> 29;
+        }
+        sum += (long)(h & 0xffff);
+    }
+    return sum;
+}
+
+static reduce_op_t ops[] = {
+    { "sum", NULL },
+    { "mix", mix_kernel },
+    { "skew", skew_kernel },
+};
+
+reduce_op_t *find_op(const char *name) {
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        if (strcmp(ops[i].name, name) == 0) {
+            if (ops[i].kernel == NULL) {
+                ops[i].kernel = select_sum_kernel();
+            }
+            return &ops[i];
+        }
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-    return NULL;
-}
\ No newline at end of file
+// Melhor tempo de BENCH_REPEATS reduções; a criação das threads entra na conta, como no programa real
+static double time_reduce(const long *data, long size, int threads, reduce_kernel_t kernel, schedule_t schedule,
+                          long *result) {
+    double best = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double start = now_seconds();
+        *result = parallel_reduce(data, size, threads, kernel, schedule, NULL);
+        double elapsed = now_seconds() - start;
+        if (r == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+static int load_tuning(tuning_entry_t *entries) {
+    FILE *file = fopen(TUNING_FILE, "r");
+    int count = 0;
+    if (file == NULL) {
+        return 0;
+    }
+    while (count < MAX_TUNING_ENTRIES &&
+           fscanf(file, "%15s %ld %d", entries[count].op, &entries[count].size, &entries[count].threads) == 3) {
+        count++;
+    }
+    fclose(file);
+    return count;
+}
+
+// Joelho ajustado para o tamanho mais próximo (em escala logarítmica); 0 se não houver medição
+int load_tuned_threads(const char *op, long size) {
+    tuning_entry_t entries[MAX_TUNING_ENTRIES];
+    int count = load_tuning(entries), best = 0;
+    double best_distance = 0;
+
+    for (int i = 0; i < count; i++) {
+        double distance = fabs(log2((double)entries[i].size / size));
+        if (strcmp(entries[i].op, op) == 0 && (best == 0 || distance < best_distance)) {
+            best = entries[i].threads;
+            best_distance = distance;
+        }
+    }
+    return (best > 0 && best < MIN_THREADS) ? MIN_THREADS : best;             // Arquivos antigos podem ter joelho 1
+}
+
+void save_tuned_threads(const char *op, long size, int threads) {
+    tuning_entry_t entries[MAX_TUNING_ENTRIES];
+    int count = load_tuning(entries), i;
+
+    for (i = 0; i < count; i++) {
+        if (strcmp(entries[i].op, op) == 0 && entries[i].size == size) {
+            break;
+        }
+    }
+    if (i == MAX_TUNING_ENTRIES) {
+        return;
+    }
+    if (i == count) {
+        snprintf(entries[i].op, sizeof(entries[i].op), "%s", op);
+        entries[i].size = size;
+        count++;
+    }
+    entries[i].threads = threads < MIN_THREADS ? MIN_THREADS : threads;     // Joelho 1 vira o mínimo aceito
+
+    FILE *file = fopen(TUNING_FILE, "w");
+    if (file == NULL) {
+        perror("Failed to write " TUNING_FILE);
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        fprintf(file, "%s %ld %d\n", entries[i].op, entries[i].size, entries[i].threads);
+    }
+    fclose(file);
+}
+
+// Próximo ponto da varredura (x * factor), terminando sempre no próprio limite; 0 encerra
+static long next_step(long x, long limit, long factor) {
+    if (x >= limit) {
+        return 0;
+    }
+    return x * factor < limit ? x * factor : limit;
+}
+
+int run_benchmark(int argc, char *argv[]) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = online * 2 > 4 ? (int)online * 2 : 4;          // Passa do número de núcleos para mostrar o joelho
+    long max_size = BENCH_DEFAULT_MAX_SIZE;
+    const char *op_name = "sum";
+    int option;
+
+    while ((option = getopt(argc, argv, "o:t:s:")) != -1) {
+        switch (option) {
+            case 'o': op_name = optarg; break;
+            case 't': max_threads = atoi(optarg); break;
+            case 's': max_size = atol(optarg); break;
+            default:
+                fprintf(stderr, "Usage: ./ex1 bench [-o sum|mix|skew] [-t max_threads] [-s max_size]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    reduce_op_t *op = find_op(op_name);
+    if (op == NULL || max_threads < 1 || max_size < 100) {
+        fprintf(stderr, "Invalid benchmark options (operations: sum, mix, skew).\n");
+        return EXIT_FAILURE;
+    }
+    reduce_kernel_t sum_kernel = find_op("sum")->kernel;
+
+    num_threads = max_threads;                                       // O preenchimento usa todas as threads
+    vector = initialize_vector(max_size);
+    long result;
+
+    // Teto de banda: leitura do maior vetor, com uma thread por núcleo, pelo kernel de soma
+    double roofline = max_size * sizeof(long) /
+                      time_reduce(vector, max_size, (int)online, sum_kernel, SCHEDULE_STATIC, &result) / 1e9;
+    printf("Operation: %s | memory roofline (read, %ld threads, %.0f MB): %.2f GB/s\n\n",
+           op->name, online, max_size * sizeof(long) / 1e6, roofline);
+
+    for (long size = 1L << 16 < max_size ? 1L << 16 : max_size; size; size = next_step(size, max_size, 16)) {
+        double best_time = 0, base_time = 0, static_base_time = 0;
+        double *times = (double *)malloc((max_threads + 1) * sizeof(double));
+        int best_threads = 1;
+
+        printf("Size %ld (%.1f MB)\n", size, size * sizeof(long) / 1e6);
+        printf("  threads   time (ms)      GB/s   %% roofline   speedup   static (ms)   static speedup\n");
+        for (int threads = 1; threads; threads = (int)next_step(threads, max_threads, 2)) {
+            long static_result;
+            double static_elapsed = time_reduce(vector, size, threads, op->kernel, SCHEDULE_STATIC, &static_result);
+            double elapsed = time_reduce(vector, size, threads, op->kernel, SCHEDULE_STEALING, &result);
+            double gbps = size * sizeof(long) / elapsed / 1e9;
+
+            if (result != static_result || (op->kernel == sum_kernel && result != size * (size - 1) / 2)) {
+                fprintf(stderr, "Wrong result with %d threads: %ld (static: %ld)\n", threads, result, static_result);
+                free(times);
+                free(vector);
+                return EXIT_FAILURE;
+            }
+            if (threads == 1) {
+                base_time = elapsed;
+                static_base_time = static_elapsed;
+            }
+            if (best_time == 0 || elapsed < best_time) {
+                best_time = elapsed;
+                best_threads = threads;
+            }
+            times[threads] = elapsed;
+            printf("  %7d   %9.3f   %7.2f   %9.1f%%   %6.2fx   %11.3f   %13.2fx%s\n", threads, elapsed * 1e3, gbps,
+                   100 * gbps / roofline, base_time / elapsed, static_elapsed * 1e3, static_base_time / static_elapsed,
+                   gbps > roofline ? "  (cache)" : "");
+        }
+
+        // Joelho: a menor contagem testada cujo tempo fica a KNEE_TOLERANCE do melhor
+        int knee = best_threads;
+        for (int threads = 1; threads; threads = (int)next_step(threads, max_threads, 2)) {
+            if (times[threads] <= best_time * KNEE_TOLERANCE) {
+                knee = threads;
+                break;
+            }
+        }
+        printf("  knee: %d threads (best %.3f ms with %d)", knee, best_time * 1e3, best_threads);
+        if (knee < MIN_THREADS) {
+            printf("; saved as %d (minimum)", MIN_THREADS);
+        }
+        printf("\n\n");
+        save_tuned_threads(op->name, size, knee);
+        free(times);
+    }
+
+    printf("Tuned thread counts saved to %s\n", TUNING_FILE);
+    free(vector);
+    return 0;
+}
@@ -1,89 +1,564 @@
-produtor-consumidor
 /*
+ * produtor-consumidor
+ *
  * Múltiplos produtores e consumidores.
+ *
+ * O buffer é uma fila circular limitada sem locks (MPMC): cada posição
+ * carrega um número de sequência que diz se ela está livre para o
+ * produtor da "volta" atual ou ocupada para o consumidor. Produtores
+ * disputam apenas o índice de cauda e consumidores apenas o de cabeça,
+ * cada um em sua própria linha de cache.
+ *
+ * As operações em lote reservam várias posições consecutivas com um
+ * único CAS. Quando a fila está cheia/vazia, a thread gira um pouco
+ * (o limite se adapta ao que funcionou antes) e só então dorme num
+ * futex, que é acordado apenas se houver alguém dormindo.
+ *
+ * Uso: ./ex2 [-p produtores] [-c consumidores] [-n posições] [-l lote]
+ *        demonstração (padrão: 5 produtores, 5 consumidores, 32 posições)
+ *      ./ex2 bench [opções]
+ *        vazão (itens/s) com semáforos, sem locks item a item e sem
+ *        locks em lote, variando produtores/consumidores até -p/-c
+ *        (padrão 8)
  */
-//#define __USE_GNU 1 
+//#define __USE_GNU 1
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 
 #include <semaphore.h>
 
+/* Padrões; ajustáveis por linha de comando */
 #define N_PRODUTORES 5
 #define N_CONSUMIDORES 5
+#define N_ITENS 32 /* Tamanho do buffer (arredondado para potência de 2) */
+#define TAM_LOTE 16
 
-#define N_ITENS 30 /* Tamanho do buffer */
-int buffer[N_ITENS];
+#define LINHA_CACHE 64
 
-/* Itens a serem produzidos por um produtor */
-#define PRODUCAO N_ITENS * 3
+/* Limites do giro adaptativo antes de dormir no futex */
+#define SPIN_MINIMO 16
+#define SPIN_MAXIMO 4096
+#define RENDIMENTOS 8  /* sched_yield() entre o giro e o futex */
 
-sem_t pos_vazia;
-sem_t pos_ocupada;
-sem_t lock_prod;
-sem_t lock_cons;
+/* Benchmark: total de itens movidos por configuração e P/C padrão */
+#define ITENS_BENCH 2000000
+#define THREADS_BENCH 8
 
-int inicio = 0, final = 0;
+int n_produtores, n_consumidores;  /* 0 = padrão do modo */
+int n_itens = N_ITENS;
+int tam_lote = TAM_LOTE;
+
+/* ---------------- Fila sem locks (sequência por posição) ---------------- */
+
+typedef struct {
+  atomic_size_t seq;  /* == pos: livre p/ produtor; == pos+1: ocupada */
+  int valor;
+} celula_t;
+
+typedef struct {
+  _Alignas(LINHA_CACHE) atomic_size_t cauda;   /* próxima escrita */
+  _Alignas(LINHA_CACHE) atomic_size_t cabeca;  /* próxima leitura */
+  /* Consumidores dormem em epoca_itens, produtores em epoca_espaco */
+  _Alignas(LINHA_CACHE) atomic_uint epoca_itens;
+  atomic_uint consumidores_dormindo;
+  _Alignas(LINHA_CACHE) atomic_uint epoca_espaco;
+  atomic_uint produtores_dormindo;
+  _Alignas(LINHA_CACHE) atomic_int limite_spin;
+  atomic_long estacionamentos;  /* Quantas vezes alguém dormiu no kernel */
+  _Alignas(LINHA_CACHE) celula_t *celulas;
+  size_t mascara;
+} fila_t;
+
+static long futex(atomic_uint *endereco, int operacao, unsigned valor) {
+  return syscall(SYS_futex, (uint32_t*)endereco, operacao, valor, NULL, NULL, 0);
+}
+
+static inline void cpu_relaxar(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/* Capacidade mínima 2: com 1 posição "livre" e "ocupada" se confundem */
+size_t capacidade_fila(int n) {
+  size_t capacidade = 2;
+
+  while (capacidade < (size_t)n)
+    capacidade <<= 1;
+  return capacidade;
+}
+
+void fila_init(fila_t *f, int n) {
+  size_t i, capacidade = capacidade_fila(n);
+
+  f->celulas = malloc(capacidade * sizeof(celula_t));
+  if (!f->celulas) {
+    perror("malloc");
+    exit(1);
+  }
+  f->mascara = capacidade - 1;
+  for (i = 0; i < capacidade; i++)
+    atomic_init(&f->celulas[i].seq, i);
+  atomic_init(&f->cauda, 0);
+  atomic_init(&f->cabeca, 0);
+  atomic_init(&f->epoca_itens, 0);
+  atomic_init(&f->consumidores_dormindo, 0);
+  atomic_init(&f->epoca_espaco, 0);
+  atomic_init(&f->produtores_dormindo, 0);
+  atomic_init(&f->limite_spin, SPIN_MINIMO * 8);
+  atomic_init(&f->estacionamentos, 0);
+}
+
+void fila_destroy(fila_t *f) {
+  free(f->celulas);
+  f->celulas = NULL;
+}
+
+/*
+ * Reserva até max posições consecutivas a partir de *indice cujas
+ * células têm seq == pos + desloc (0: livres, 1: ocupadas). Uma célula
+ * nesse estado só muda pela thread que reservar a sua posição, então
+ * um único CAS garante todas. Retorna 0 se a fila estiver cheia/vazia.
+ */
+static size_t reservar(fila_t *f, atomic_size_t *indice, size_t desloc,
+                       size_t max, size_t *inicio) {
+  size_t pos = atomic_load_explicit(indice, memory_order_relaxed), k;
+  intptr_t dif = 0;
+
+  for (;;) {
+    for (k = 0; k < max; k++) {
+      dif = (intptr_t)atomic_load_explicit(&f->celulas[(pos + k) & f->mascara].seq,
+                                           memory_order_acquire)
+            - (intptr_t)(pos + k + desloc);
+      if (dif != 0)
+        break;
+    }
+    if (k > 0) {
+      if (atomic_compare_exchange_weak_explicit(indice, &pos, pos + k,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        *inicio = pos;
+        return k;
+      }
+    } else if (dif < 0) {
+      return 0;  /* A outra ponta ainda não liberou/publicou esta posição */
+    } else {
+      pos = atomic_load_explicit(indice, memory_order_relaxed);
+    }
+  }
+}
+
+/* Acorda até n threads dormindo do outro lado, se houver alguma */
+static void acordar(atomic_uint *epoca, atomic_uint *dormindo, size_t n) {
+  /* Ordena a publicação das células antes da leitura de "dormindo";
+   * par da barreira em operar_bloqueante */
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(dormindo, memory_order_relaxed) == 0)
+    return;
+  atomic_fetch_add(epoca, 1);
+  futex(epoca, FUTEX_WAKE_PRIVATE, n > INT_MAX ? INT_MAX : (unsigned)n);
+}
+
+/* Insere até n itens de uma vez; retorna quantos couberam */
+size_t fila_tenta_inserir_lote(fila_t *f, const int *valores, size_t n) {
+  size_t pos, k, i;
+
+  k = reservar(f, &f->cauda, 0, n, &pos);
+  for (i = 0; i < k; i++) {
+    celula_t *c = &f->celulas[(pos + i) & f->mascara];
+    /* Escreve antes de publicar: nenhuma posição é pulada ou lida vazia */
+    c->valor = valores[i];
+    atomic_store_explicit(&c->seq, pos + i + 1, memory_order_release);
+  }
+  if (k)
+    acordar(&f->epoca_itens, &f->consumidores_dormindo, k);
+  return k;
+}
+
+/* Remove até max itens de uma vez; retorna quantos havia */
+size_t fila_tenta_remover_lote(fila_t *f, int *valores, size_t max) {
+  size_t pos, k, i;
+
+  k = reservar(f, &f->cabeca, 1, max, &pos);
+  for (i = 0; i < k; i++) {
+    celula_t *c = &f->celulas[(pos + i) & f->mascara];
+    valores[i] = c->valor;
+    /* Libera a posição para o produtor da próxima volta */
+    atomic_store_explicit(&c->seq, pos + i + f->mascara + 1, memory_order_release);
+  }
+  if (k)
+    acordar(&f->epoca_espaco, &f->produtores_dormindo, k);
+  return k;
+}
+
+/*
+ * Espera até conseguir mover pelo menos um item. Primeiro gira até
+ * limite_spin tentativas e cede o processador algumas vezes (com menos
+ * núcleos que threads o outro lado só anda se esta thread sair da
+ * CPU); se não bastar, registra-se como dormindo,
+ * tenta de novo (a inserção/remoção concorrente pode ter visto o
+ * contador zerado) e dorme na época. O limite cresce quando o giro
+ * resolve e cai pela metade quando não resolve. Insere de "origem" ou,
+ * com origem NULL, remove para "destino".
+ */
+static size_t operar_bloqueante(fila_t *f, const int *origem, int *destino,
+                                size_t n) {
+  int inserir = (origem != NULL);
+  atomic_uint *epoca = inserir ? &f->epoca_espaco : &f->epoca_itens;
+  atomic_uint *dormindo = inserir ? &f->produtores_dormindo : &f->consumidores_dormindo;
+  int limite = atomic_load_explicit(&f->limite_spin, memory_order_relaxed);
+  int i;
+  unsigned e;
+  size_t k;
+
+#define TENTAR() (inserir ? fila_tenta_inserir_lote(f, origem, n) \
+                          : fila_tenta_remover_lote(f, destino, n))
+  for (i = 0; i < limite; i++) {
+    if ((k = TENTAR())) {
+      if (i > 0 && limite < SPIN_MAXIMO)
+        atomic_store_explicit(&f->limite_spin, limite + limite / 4 + 1,
+                              memory_order_relaxed);
+      return k;
+    }
+    cpu_relaxar();
+  }
+  if (limite > SPIN_MINIMO)
+    atomic_store_explicit(&f->limite_spin, limite / 2, memory_order_relaxed);
+
+  for (i = 0; i < RENDIMENTOS; i++) {
+    sched_yield();
+    if ((k = TENTAR()))
+      return k;
+  }
+
+  for (;;) {
+    e = atomic_load(epoca);
+    atomic_fetch_add(dormindo, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!(k = TENTAR())) {
+      atomic_fetch_add_explicit(&f->estacionamentos, 1, memory_order_relaxed);
+      futex(epoca, FUTEX_WAIT_PRIVATE, e);
+    }
+    atomic_fetch_sub(dormindo, 1);
+    if (k || (k = TENTAR()))
+      break;
+  }
+#undef TENTAR
+
+  return k;
+}
+
+/* Versões bloqueantes */
+void fila_inserir_lote(fila_t *f, const int *valores, size_t n) {
+  size_t k;
+
+  while (n > 0) {
+    k = operar_bloqueante(f, valores, NULL, n);
+    valores += k;
+    n -= k;
+  }
+}
+
+/* Bloqueia até haver ao menos um item; retorna quantos removeu (<= max) */
+size_t fila_remover_lote(fila_t *f, int *valores, size_t max) {
+  return operar_bloqueante(f, NULL, valores, max);
+}
+
+void fila_inserir(fila_t *f, int valor) {
+  fila_inserir_lote(f, &valor, 1);
+}
+
+int fila_remover(fila_t *f) {
+  int valor;
+
+  fila_remover_lote(f, &valor, 1);
+  return valor;
+}
+
+/* ---------------- Fila com semáforos (referência) ---------------- */
+
+typedef struct {
+  int *buffer;
+  int capacidade;
+  int inicio, final;
+  sem_t pos_vazia;
+  sem_t pos_ocupada;
+  sem_t lock_prod;
+  sem_t lock_cons;
+} fila_sem_t;
+
+void fila_sem_init(fila_sem_t *f, int n) {
+  f->capacidade = (int)capacidade_fila(n);
+  f->buffer = malloc(f->capacidade * sizeof(int));
+  if (!f->buffer) {
+    perror("malloc");
+    exit(1);
+  }
+  f->inicio = f->final = 0;
+  sem_init(&f->pos_vazia, 0, f->capacidade);
+  sem_init(&f->pos_ocupada, 0, 0);
+  sem_init(&f->lock_prod, 0, 1);
+  sem_init(&f->lock_cons, 0, 1);
+}
+
+void fila_sem_destroy(fila_sem_t *f) {
+  sem_destroy(&f->pos_vazia);
+  sem_destroy(&f->pos_ocupada);
+  sem_destroy(&f->lock_cons);
+  sem_destroy(&f->lock_prod);
+  free(f->buffer);
+}
+
+void fila_sem_inserir(fila_sem_t *f, int valor) {
+  sem_wait(&f->pos_vazia);
+  sem_wait(&f->lock_prod);
+  f->buffer[f->final] = valor;
+  f->final = (f->final + 1) % f->capacidade;
+  sem_post(&f->lock_prod);
+  sem_post(&f->pos_ocupada);
+}
+
+int fila_sem_remover(fila_sem_t *f) {
+  int valor;
+
+  sem_wait(&f->pos_ocupada);
+  sem_wait(&f->lock_cons);
+  valor = f->buffer[f->inicio];
+  f->inicio = (f->inicio + 1) % f->capacidade;
+  sem_post(&f->lock_cons);
+  sem_post(&f->pos_vazia);
+  return valor;
+}
+
+/* ---------------- Demonstração ---------------- */
+
+fila_t fila;
+int producao;  /* Itens a serem produzidos por um produtor */
 
 void* produtor(void *v) {
   int i;
 
-  for (i = 0; i < PRODUCAO; i++) {
-    sem_wait(&pos_vazia);
-    sem_wait(&lock_prod);
-    printf("Produtor, item = %d.\n", i);     
-    final = (final + 1) % N_ITENS;
-    buffer[final] = i;
-    sem_post(&lock_prod);
-    sem_post(&pos_ocupada);
+  (void)v;
+  for (i = 0; i < producao; i++) {
+    printf("Produtor, item = %d.\n", i);
+    fila_inserir(&fila, i);
     sleep(random() % 3);  /* Permite que outra thread execute */
   }
   return NULL;
 }
 
 void* consumidor(void *v) {
-  int i;
+  int id = (int)(intptr_t)v;
+  int total = producao * n_produtores;
+  int i, cota = total / n_consumidores + (id < total % n_consumidores);
 
-  for (i = 0; i < (PRODUCAO * N_PRODUTORES)/N_CONSUMIDORES; i++) {
-    sem_wait(&pos_ocupada);
-    sem_wait(&lock_cons);
-    inicio = (inicio + 1) % N_ITENS;
-    printf("Consumidor, item = %d.\n", buffer[inicio]);
-    sem_post(&lock_cons);
-    sem_post(&pos_vazia);
-    sleep(random() % 3);  /* Permite que outra thread execute */  
+  for (i = 0; i < cota; i++) {
+    printf("Consumidor, item = %d.\n", fila_remover(&fila));
+    sleep(random() % 3);  /* Permite que outra thread execute */
   }
   return NULL;
 }
 
-int main() {
+/* ---------------- Benchmark ---------------- */
+
+enum { BENCH_SEMAFOROS, BENCH_ITEM, BENCH_LOTE };
+
+fila_sem_t fila_sem;
+int modo_bench;
+atomic_long restantes;  /* Itens ainda não reivindicados por consumidores */
+
+void* produtor_bench(void *v) {
+  long i, j, n = (long)(intptr_t)v;
+  int *lote;
+
+  if (modo_bench == BENCH_SEMAFOROS) {
+    for (i = 0; i < n; i++)
+      fila_sem_inserir(&fila_sem, (int)i);
+  } else if (modo_bench == BENCH_ITEM) {
+    for (i = 0; i < n; i++)
+      fila_inserir(&fila, (int)i);
+  } else {
+    lote = malloc(tam_lote * sizeof(int));
+    for (i = 0; i < n; i += j) {
+      for (j = 0; j < tam_lote && i + j < n; j++)
+        lote[j] = (int)(i + j);
+      fila_inserir_lote(&fila, lote, j);
+    }
+    free(lote);
+  }
+  return NULL;
+}
+
+void* consumidor_bench(void *v) {
+  long long *soma = v;
+  long pedido, quero, recebidos;
+  int passo = modo_bench == BENCH_LOTE ? tam_lote : 1;
+  int *lote = malloc(passo * sizeof(int));
+  size_t k, j;
+
+  /* Reivindica até "passo" itens que com certeza ainda serão produzidos */
+  while ((pedido = atomic_fetch_sub(&restantes, passo)) > 0) {
+    quero = pedido < passo ? pedido : passo;
+    for (recebidos = 0; recebidos < quero; recebidos += k) {
+      if (modo_bench == BENCH_SEMAFOROS) {
+        lote[0] = fila_sem_remover(&fila_sem);
+        k = 1;
+      } else {
+        k = fila_remover_lote(&fila, lote, quero - recebidos);
+      }
+      for (j = 0; j < k; j++)
+        *soma += lote[j];
+    }
+  }
+  free(lote);
+  return NULL;
+}
 
-  pthread_t thr_produtor[N_PRODUTORES], thr_consumidor[N_CONSUMIDORES];
+/* Retorna itens/s; aborta se algum item se perder ou duplicar */
+double medir_vazao(int modo, int produtores, int consumidores, long *estacionamentos) {
+  pthread_t *thr_produtor = malloc(produtores * sizeof(pthread_t));
+  pthread_t *thr_consumidor = malloc(consumidores * sizeof(pthread_t));
+  long long *somas = calloc(consumidores, sizeof(long long)), soma = 0;
+  long por_produtor = ITENS_BENCH / produtores;
+  long total = por_produtor * produtores;
+  struct timespec t0, t1;
+  double segundos;
   int i;
 
+  modo_bench = modo;
+  fila_init(&fila, n_itens);
+  fila_sem_init(&fila_sem, n_itens);
+  atomic_store(&restantes, total);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 0; i < consumidores; i++)
+    pthread_create(&thr_consumidor[i], NULL, consumidor_bench, &somas[i]);
+  for (i = 0; i < produtores; i++)
+    pthread_create(&thr_produtor[i], NULL, produtor_bench,
+                   (void*)(intptr_t)por_produtor);
+  for (i = 0; i < produtores; i++)
+    pthread_join(thr_produtor[i], NULL);
+  for (i = 0; i < consumidores; i++)
+    pthread_join(thr_consumidor[i], NULL);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  for (i = 0; i < consumidores; i++)
+    soma += somas[i];
+  if (soma != (long long)produtores * por_produtor * (por_produtor - 1) / 2) {
+    fprintf(stderr, "✗ Soma dos itens consumidos incorreta (modo %d, %dP/%dC)\n",
+            modo, produtores, consumidores);
+    exit(1);
+  }
+
+  *estacionamentos = atomic_load(&fila.estacionamentos);
+  fila_destroy(&fila);
+  fila_sem_destroy(&fila_sem);
+  free(thr_produtor);
+  free(thr_consumidor);
+  free(somas);
+  segundos = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  return total / segundos;
+}
+
+/* Potências de 2 até o limite, terminando sempre no próprio limite */
+int proximo_passo(int x, int limite) {
+  if (x >= limite)
+    return 0;
+  return x * 2 <= limite ? x * 2 : limite;
+}
+
+void benchmark(void) {
+  int p, c;
+  long park_item, park_lote, ignorado;
+  double v_sem, v_item, v_lote;
 
-  sem_init(&pos_vazia, 0, N_ITENS);
-  sem_init(&pos_ocupada, 0, 0);
-  sem_init(&lock_prod, 0, 1);
-  sem_init(&lock_cons, 0, 1);
-  
-  for (i = 0; i < N_PRODUTORES; i++)
+  printf("%d itens por configuração, buffer de %zu posições, lote de %d\n\n",
+         ITENS_BENCH, capacidade_fila(n_itens), tam_lote);
+  printf(" P  C   semáforos (it/s)   sem locks (it/s)      lote (it/s)"
+         "    ganho   dormidas item/lote\n");
+  for (p = 1; p; p = proximo_passo(p, n_produtores)) {
+    for (c = 1; c; c = proximo_passo(c, n_consumidores)) {
+      v_sem = medir_vazao(BENCH_SEMAFOROS, p, c, &ignorado);
+      v_item = medir_vazao(BENCH_ITEM, p, c, &park_item);
+      v_lote = medir_vazao(BENCH_LOTE, p, c, &park_lote);
+      printf("%2d %2d   %16.0f   %16.0f   %14.0f   %6.1fx   %8ld/%ld\n",
+             p, c, v_sem, v_item, v_lote, v_lote / v_sem, park_item, park_lote);
+    }
+  }
+}
+
+void uso(const char *programa) {
+  fprintf(stderr, "Uso: %s [bench] [-p produtores] [-c consumidores] "
+          "[-n posições] [-l lote]\n", programa);
+  exit(1);
+}
+
+int main(int argc, char *argv[]) {
+
+  pthread_t *thr_produtor, *thr_consumidor;
+  int i, opcao, modo_benchmark = 0;
+
+  if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+    modo_benchmark = 1;
+    argv[1] = argv[0];
+    argc--;
+    argv++;
+  }
+
+  while ((opcao = getopt(argc, argv, "p:c:n:l:")) != -1) {
+    switch (opcao) {
+      case 'p': n_produtores = atoi(optarg); break;
+      case 'c': n_consumidores = atoi(optarg); break;
+      case 'n': n_itens = atoi(optarg); break;
+      case 'l': tam_lote = atoi(optarg); break;
+      default: uso(argv[0]);
+    }
+  }
+  if (n_produtores < 0 || n_consumidores < 0 || n_itens < 1 || tam_lote < 1)
+    uso(argv[0]);
+  if (n_produtores == 0)
+    n_produtores = modo_benchmark ? THREADS_BENCH : N_PRODUTORES;
+  if (n_consumidores == 0)
+    n_consumidores = modo_benchmark ? THREADS_BENCH : N_CONSUMIDORES;
+
+  if (modo_benchmark) {
+    benchmark();
+    return 0;
+  }
+
+  fila_init(&fila, n_itens);
+  producao = (int)capacidade_fila(n_itens) * 3;
+
+  thr_produtor = malloc(n_produtores * sizeof(pthread_t));
+  thr_consumidor = malloc(n_consumidores * sizeof(pthread_t));
+
+  for (i = 0; i < n_produtores; i++)
     pthread_create(&thr_produtor[i], NULL, produtor, NULL);
 
-  for (i = 0; i < N_CONSUMIDORES; i++)
-    pthread_create(&thr_consumidor[i], NULL, consumidor, NULL);
+  for (i = 0; i < n_consumidores; i++)
+    pthread_create(&thr_consumidor[i], NULL, consumidor, (void*)(intptr_t)i);
 
-  for (i = 0; i < N_PRODUTORES; i++)
-    pthread_join(thr_produtor[i], NULL); 
+  for (i = 0; i < n_produtores; i++)
+    pthread_join(thr_produtor[i], NULL);
 
-  for (i = 0; i < N_CONSUMIDORES; i++)
+  for (i = 0; i < n_consumidores; i++)
     pthread_join(thr_consumidor[i], NULL);
 
-  sem_destroy(&pos_vazia);
-  sem_destroy(&pos_ocupada);
-  sem_destroy(&lock_cons);
-  sem_destroy(&lock_prod);
-  
-  return 0;
-}
\ No newline at end of file
+  fila_destroy(&fila);
+  free(thr_produtor);
+  free(thr_consumidor);
+
+  return 0;
+}
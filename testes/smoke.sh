@@ -0,0 +1,36 @@
+#!/bin/sh
+# Verificações rápidas dos programas já compilados em $1 (padrão build/): soma do ex1, checagem de
+# somas do benchmark do ex2, ida e volta de um snapshot e reprodução de uma gravação de concessões.
+set -e
+BUILD=${1:-build}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+falhou() {
+    echo "✗ $1"
+    exit 1
+}
+
+# ex1: soma de 0..99999 com 2 threads
+SOMA=$(printf '100000\n2\n' | "$BUILD/ex1" | tail -n 1)
+[ "$SOMA" = "4999950000" ] || falhou "ex1: soma $SOMA, esperado 4999950000"
+
+# ex2: o benchmark confere a soma dos itens consumidos e encerra com erro se ela não bater
+"$BUILD/ex2" bench -p 1 -c 2 > "$TMP/ex2.out" || falhou "ex2: benchmark falhou"
+
+# Simulador: snapshot salvo em t = 10 s e restaurado com os mesmos aviões e relógio
+SIM="$BUILD/aeroporto --acelerar 100"
+$SIM --pistas 2 --portoes 3 --torre 2 --tempo 30 --semente 7 \
+     --salvar-snapshot "$TMP/s.bin" --snapshot-em 10 > "$TMP/salvar.out" 2>&1 || falhou "snapshot: execução falhou"
+SALVO=$(grep -a -o 'Snapshot salvo em [^ ]* ([0-9]* aviões, t=[0-9.]*s)' "$TMP/salvar.out" | sed 's/.*(\(.*\))/\1/')
+[ -n "$SALVO" ] || falhou "snapshot: não foi salvo"
+$SIM --carregar-snapshot "$TMP/s.bin" < /dev/null > "$TMP/carregar.out" 2>&1 || falhou "snapshot: restauração falhou"
+grep -a -q "restaurado: $SALVO" "$TMP/carregar.out" || falhou "snapshot: restaurado diferente do salvo ($SALVO)"
+
+# Simulador: a reprodução repete a ordem gravada de todas as concessões
+$SIM --pistas 2 --portoes 3 --torre 2 --tempo 30 --semente 7 \
+     --gravar-concessoes "$TMP/c.bin" > "$TMP/gravar.out" 2>&1 || falhou "concessões: gravação falhou"
+$SIM --reproduzir-concessoes "$TMP/c.bin" < /dev/null > "$TMP/reproduzir.out" 2>&1 || falhou "concessões: reprodução falhou"
+grep -a -q "Execução idêntica à gravada" "$TMP/reproduzir.out" || falhou "concessões: reprodução divergiu"
+
+echo "✓ Verificações rápidas passaram (ex1, ex2, snapshot, reprodução de concessões)"
@@ -0,0 +1,495 @@
+// Testes de unidade das partes determinísticas do simulador: estatísticas (percentis, MSER-5, médias
+// de lotes), linha do tempo de capacidade, sequenciamento de pistas, replay da faixa de urgência,
+// herança de prioridade, rotas da malha de taxiamento e passo do terminal de passageiros. Compilado
+// com -DAEROPORTO_BIBLIOTECA, incluindo aeroporto.c para alcançar as funções internas.
+
+#include "aeroporto.c"
+
+static int falhas = 0;
+
+#define VERIFICAR(condicao, ...) do {                  \
+    if (!(condicao)) {                                 \
+        printf("✗ %s:%d: ", __FILE__, __LINE__);        \
+        printf(__VA_ARGS__);                           \
+        printf("\n");                                  \
+        falhas++;                                      \
+    }                                                  \
+} while (0)
+
+static int perto(double a, double b, double tolerancia) {
+    return fabs(a - b) <= tolerancia;
+}
+
+// ========== PERCENTIL DAS ESPERAS ==========
+
+static void registrar_esperas(int* histograma, double* maximo, double espera, int vezes) {
+    histograma[faixa_espera(espera)] += vezes;
+    if (espera > *maximo) *maximo = espera;
+}
+
+static void testar_percentil_espera() {
+    int histograma[FAIXAS_HISTOGRAMA_ESPERA] = {0};
+    double maximo = 0;
+    VERIFICAR(percentil_espera(histograma, maximo, 0.99) == 0.0, "histograma vazio deveria dar 0");
+
+    // Uma única espera: o percentil não passa dela (antes dava o limite superior da faixa)
+    registrar_esperas(histograma, &maximo, 85.77, 1);
+    double p99 = percentil_espera(histograma, maximo, 0.99);
+    VERIFICAR(p99 <= 85.77 && p99 > 85.77 / 1.19, "p99 de uma espera de 85.77 s: %.3f", p99);
+
+    // 99 esperas de 10 ms e uma de 85.77 s: p50 fica na faixa dos 10 ms, p99 abaixo do máximo
+    registrar_esperas(histograma, &maximo, 0.010, 99);
+    double faixa_inferior = ESPERA_MINIMA_HISTOGRAMA * pow(2.0, (faixa_espera(0.010) - 1) / 4.0);
+    double faixa_superior = ESPERA_MINIMA_HISTOGRAMA * pow(2.0, faixa_espera(0.010) / 4.0);
+    double p50 = percentil_espera(histograma, maximo, 0.50);
+    VERIFICAR(p50 >= faixa_inferior && p50 <= faixa_superior, "p50 %.5f fora da faixa [%.5f, %.5f]",
+              p50, faixa_inferior, faixa_superior);
+
+    // Monótono em q e nunca acima da maior espera
+    double anterior = 0;
+    for (double q = 0.05; q <= 1.0; q += 0.05) {
+        double p = percentil_espera(histograma, maximo, q);
+        VERIFICAR(p >= anterior, "percentil não monótono em q = %.2f (%.5f < %.5f)", q, p, anterior);
+        VERIFICAR(p <= maximo, "percentil %.2f = %.3f acima do máximo %.3f", q, p, maximo);
+        anterior = p;
+    }
+    VERIFICAR(perto(percentil_espera(histograma, maximo, 1.0), maximo, 1e-9), "p100 deveria ser o máximo");
+
+    // Interpolação: metade das contagens da faixa dá o ponto médio dela
+    int uniforme[FAIXAS_HISTOGRAMA_ESPERA] = {0};
+    int faixa = faixa_espera(0.5);
+    uniforme[faixa] = 100;
+    double inferior = ESPERA_MINIMA_HISTOGRAMA * pow(2.0, (faixa - 1) / 4.0);
+    double superior = ESPERA_MINIMA_HISTOGRAMA * pow(2.0, faixa / 4.0);
+    double mediana = percentil_espera(uniforme, superior, 0.5);
+    VERIFICAR(perto(mediana, (inferior + superior) / 2, 1e-9), "mediana %.6f, esperado %.6f",
+              mediana, (inferior + superior) / 2);
+}
+
+// ========== AQUECIMENTO E MÉDIAS DE LOTES ==========
+
+static void testar_truncamento_mser5() {
+    double serie[100];
+    for (int i = 0; i < 100; i++) {
+        serie[i] = (i < 20) ? 100.0 : 10.0; // Aquecimento de 20 observações, depois regime constante
+    }
+    VERIFICAR(truncamento_mser5(serie, 100) == 20, "corte %d, esperado 20", truncamento_mser5(serie, 100));
+
+    for (int i = 0; i < 100; i++) serie[i] = 42.0;
+    VERIFICAR(truncamento_mser5(serie, 100) == 0, "série constante não deveria ser truncada");
+    VERIFICAR(truncamento_mser5(serie, 19) == 0, "menos de 4 lotes não deveria ser truncada");
+
+    // O corte fica na primeira metade mesmo quando o transiente é mais longo
+    for (int i = 0; i < 100; i++) serie[i] = 200.0 - i;
+    VERIFICAR(truncamento_mser5(serie, 100) <= 50, "corte %d passa da metade", truncamento_mser5(serie, 100));
+}
+
+static void testar_meia_largura_lotes() {
+    double serie[10];
+    for (int i = 0; i < 10; i++) serie[i] = i + 1;
+    VERIFICAR(meia_largura_lotes(serie, 9) < 0, "série curta deveria dar -1");
+
+    // Lotes de 2: médias 1.5, 3.5, 5.5, 7.5, 9.5 (variância 10) → t(4) · sqrt(10 / 5)
+    double esperado = 2.776 * sqrt(2.0);
+    VERIFICAR(perto(meia_largura_lotes(serie, 10), esperado, 1e-9), "meia-largura %.6f, esperado %.6f",
+              meia_largura_lotes(serie, 10), esperado);
+
+    // A sobra do fim (n não múltiplo do número de lotes) fica de fora
+    double com_sobra[11];
+    memcpy(com_sobra, serie, sizeof(serie));
+    com_sobra[10] = 1e6;
+    VERIFICAR(perto(meia_largura_lotes(com_sobra, 11), esperado, 1e-9), "sobra entrou nos lotes");
+
+    for (int i = 0; i < 10; i++) serie[i] = 7.0;
+    VERIFICAR(meia_largura_lotes(serie, 10) == 0.0, "série constante deveria ter meia-largura 0");
+}
+
+// ========== LINHA DO TEMPO DE CAPACIDADE ==========
+
+// Grava 'texto' num arquivo temporário e o entrega a 'carregar'
+static int carregar_de_texto(int (*carregar)(const char*), const char* texto) {
+    char caminho[] = "/tmp/teste_aeroportoXXXXXX";
+    int descritor = mkstemp(caminho);
+    if (descritor < 0) {
+        perror("mkstemp");
+        exit(1);
+    }
+    FILE* arquivo = fdopen(descritor, "w");
+    fputs(texto, arquivo);
+    fclose(arquivo);
+    int resultado = carregar(caminho);
+    unlink(caminho);
+    return resultado;
+}
+
+static int carregar_texto(const char* texto) {
+    return carregar_de_texto(carregar_eventos_capacidade, texto);
+}
+
+static void testar_eventos_capacidade() {
+    int resultado = carregar_texto(
+        "# instante recurso valor descrição\n"
+        "80   pistas  normal  pista 2 reaberta\n"
+        "\n"
+        "20   pistas  -1      pista 2 fechada   # vento cruzado\n"
+        "100  torre   1\n"
+        "50.5 caminhoes +2    reforço\n");
+    VERIFICAR(resultado == 0, "arquivo válido rejeitado");
+    VERIFICAR(linha_do_tempo.num_eventos == 4, "%d eventos, esperado 4", linha_do_tempo.num_eventos);
+    if (resultado == 0 && linha_do_tempo.num_eventos == 4) {
+        const evento_capacidade_t* e = linha_do_tempo.eventos;
+        VERIFICAR(e[0].instante == 20 && e[1].instante == 50.5 && e[2].instante == 80 && e[3].instante == 100,
+                  "eventos fora de ordem");
+        VERIFICAR(e[0].alvo == ALVO_PISTAS && e[0].relativo && e[0].valor == -1, "redução relativa mal lida");
+        VERIFICAR(strncmp(e[0].descricao, "pista 2 fechada", 15) == 0, "descrição \"%s\"", e[0].descricao);
+        VERIFICAR(e[1].alvo == ALVO_CAMINHOES && e[1].relativo && e[1].valor == 2, "reforço relativo mal lido");
+        VERIFICAR(e[2].relativo && e[2].valor == 0, "\"normal\" deveria ser relativo 0");
+        VERIFICAR(e[3].alvo == ALVO_TORRE && !e[3].relativo && e[3].valor == 1, "valor absoluto mal lido");
+    }
+
+    VERIFICAR(carregar_texto("10 hangares 2\n") != 0, "recurso desconhecido aceito");
+    VERIFICAR(carregar_texto("10 pistas dois\n") != 0, "valor não numérico aceito");
+    VERIFICAR(carregar_texto("10 pistas -x\n") != 0, "valor relativo inválido aceito");
+    VERIFICAR(carregar_texto("-5 pistas 1\n") != 0, "instante negativo aceito");
+    VERIFICAR(carregar_texto("10 pistas\n") != 0, "linha sem valor aceita");
+}
+
+// ========== SEQUENCIADOR DE PISTAS ==========
+
+static void testar_separacao_minima() {
+    VERIFICAR(separacao_minima(-1, OPERACAO_POUSO, CATEGORIA_PESADA, OPERACAO_DECOLAGEM) == 0.0,
+              "pista sem operação anterior não deveria exigir separação");
+    VERIFICAR(separacao_minima(CATEGORIA_PESADA, OPERACAO_POUSO, CATEGORIA_LEVE, OPERACAO_POUSO) == 3.0,
+              "PESADA → LEVE: %.2f", separacao_minima(CATEGORIA_PESADA, OPERACAO_POUSO, CATEGORIA_LEVE, OPERACAO_POUSO));
+    VERIFICAR(separacao_minima(CATEGORIA_LEVE, OPERACAO_POUSO, CATEGORIA_PESADA, OPERACAO_POUSO) == 1.0,
+              "LEVE → PESADA deveria exigir só a separação mínima");
+    VERIFICAR(separacao_minima(CATEGORIA_PESADA, OPERACAO_POUSO, CATEGORIA_LEVE, OPERACAO_DECOLAGEM) ==
+              3.0 + SEPARACAO_TROCA_OPERACAO, "troca pouso/decolagem sem o acréscimo de configuração");
+}
+
+// Enfileira pedidos de pouso com as categorias dadas, na ordem de chegada, atrás de uma PESADA
+// que acabou de liberar a única pista
+static void preparar_fila_pistas(const categoria_esteira_t* categorias, int n) {
+    NUM_PISTAS = 1;
+    contador_avioes = 0;
+    reiniciar_sequenciador();
+    sequenciador.ultima_categoria[0] = CATEGORIA_PESADA;
+    sequenciador.ultima_operacao[0] = OPERACAO_POUSO;
+    sequenciador.fim_ultima_operacao[0] = agora_ns();
+    for (int i = 0; i < n; i++) {
+        memset(&avioes[i], 0, sizeof(aviao_t));
+        avioes[i].id = i + 1;
+        avioes[i].categoria = categorias[i];
+        avioes[i].estado = ESPERANDO_POUSO;
+        avioes[i].prazo_combustivel = agora_ns() + duracao_real_ns(3600); // Longe da faixa de urgência
+        pedido_pista_t* pedido = &pedidos_pista[i];
+        pedido->aviao = &avioes[i];
+        pedido->operacao = OPERACAO_POUSO;
+        pedido->ordem_chegada = sequenciador.proxima_ordem++;
+        pedido->pista = -1;
+        pedido->no_cabeceira = -1;
+        pedido->indice_chegada = -1;
+        pedido->ativo = 1;
+        sequenciador.fila[sequenciador.tamanho_fila++] = pedido;
+    }
+}
+
+static void testar_despachar_pistas() {
+    fator_aceleracao = 1.0;
+
+    // Atrás de uma PESADA, a PESADA (1.5 s) começa antes da LEVE (3 s) e a ultrapassa
+    categoria_esteira_t leve_e_pesada[] = {CATEGORIA_LEVE, CATEGORIA_PESADA};
+    preparar_fila_pistas(leve_e_pesada, 2);
+    pthread_mutex_lock(&sequenciador.mutex);
+    despachar_pistas();
+    pthread_mutex_unlock(&sequenciador.mutex);
+    VERIFICAR(pedidos_pista[1].pista == 0 && pedidos_pista[0].pista < 0, "a PESADA deveria ganhar a pista");
+    VERIFICAR(pedidos_pista[0].ultrapassagens == 1, "ultrapassagens da LEVE: %d", pedidos_pista[0].ultrapassagens);
+    VERIFICAR(sequenciador.resequenciamentos == 1 && sequenciador.num_operacoes == 1,
+              "%d resequenciamentos, %d operações", sequenciador.resequenciamentos, sequenciador.num_operacoes);
+
+    // Ultrapassada CPS_MAX_DESLOCAMENTO vezes, a LEVE passa a ser a próxima mesmo sendo mais lenta
+    preparar_fila_pistas(leve_e_pesada, 2);
+    pedidos_pista[0].ultrapassagens = CPS_MAX_DESLOCAMENTO;
+    pthread_mutex_lock(&sequenciador.mutex);
+    despachar_pistas();
+    pthread_mutex_unlock(&sequenciador.mutex);
+    VERIFICAR(pedidos_pista[0].pista == 0 && pedidos_pista[1].pista < 0, "deslocamento máximo não respeitado");
+    VERIFICAR(sequenciador.resequenciamentos == 0, "concessão forçada contada como resequenciamento");
+
+    // Fora da janela CPS a PESADA não é considerada, mesmo começando antes
+    categoria_esteira_t pesada_no_fim[CPS_MAX_DESLOCAMENTO + 2];
+    for (int i = 0; i < CPS_MAX_DESLOCAMENTO + 1; i++) pesada_no_fim[i] = CATEGORIA_LEVE;
+    pesada_no_fim[CPS_MAX_DESLOCAMENTO + 1] = CATEGORIA_PESADA;
+    preparar_fila_pistas(pesada_no_fim, CPS_MAX_DESLOCAMENTO + 2);
+    pthread_mutex_lock(&sequenciador.mutex);
+    despachar_pistas();
+    pthread_mutex_unlock(&sequenciador.mutex);
+    VERIFICAR(pedidos_pista[0].pista == 0 && pedidos_pista[CPS_MAX_DESLOCAMENTO + 1].pista < 0,
+              "pedido fora da janela CPS foi atendido");
+
+    // Com a única pista ocupada nada é concedido
+    preparar_fila_pistas(leve_e_pesada, 2);
+    sequenciador.pista_ocupada[0] = 1;
+    pthread_mutex_lock(&sequenciador.mutex);
+    despachar_pistas();
+    pthread_mutex_unlock(&sequenciador.mutex);
+    VERIFICAR(sequenciador.tamanho_fila == 2 && sequenciador.num_operacoes == 0, "pista ocupada foi concedida");
+}
+
+// ========== FAIXA DE URGÊNCIA (REPLAY EDF) ==========
+
+static void registrar_chegada(operacao_pista_t operacao, double instante, double prazo, double ocupacao) {
+    chegada_pista_t* chegada = &sequenciador.chegadas[sequenciador.num_chegadas++];
+    chegada->categoria = CATEGORIA_MEDIA;
+    chegada->operacao = operacao;
+    chegada->instante_chegada = instante;
+    chegada->prazo = prazo;
+    chegada->ocupacao = ocupacao;
+}
+
+static void testar_panes_secas_replay() {
+    NUM_PISTAS = 1;
+    contador_avioes = 0;
+    reiniciar_sequenciador();
+    VERIFICAR(panes_secas_replay(0) == 0 && panes_secas_replay(1) == 0, "replay sem chegadas");
+
+    // Uma decolagem longa chega junto com um pouso de 20 s de autonomia: em FCFS o pouso só começa
+    // depois dela (pane seca); com EDF o pouso urgente vai primeiro
+    registrar_chegada(OPERACAO_DECOLAGEM, 0.0, HUGE_VAL, 40.0);
+    registrar_chegada(OPERACAO_POUSO, 0.0, 20.0, 2.0);
+    VERIFICAR(panes_secas_replay(0) == 1, "FCFS: %d panes, esperado 1", panes_secas_replay(0));
+    VERIFICAR(panes_secas_replay(1) == 0, "EDF: %d panes, esperado 0", panes_secas_replay(1));
+
+    // Dois pousos urgentes: o de menor prazo vai antes, mesmo tendo chegado depois
+    reiniciar_sequenciador();
+    registrar_chegada(OPERACAO_POUSO, 0.0, 25.0, 10.0);
+    registrar_chegada(OPERACAO_POUSO, 0.0, 5.0, 10.0);
+    VERIFICAR(panes_secas_replay(0) == 1, "FCFS com dois urgentes: %d panes", panes_secas_replay(0));
+    VERIFICAR(panes_secas_replay(1) == 0, "EDF com dois urgentes: %d panes", panes_secas_replay(1));
+
+    // Fora do limiar de urgência o EDF segue a ordem de chegada
+    reiniciar_sequenciador();
+    registrar_chegada(OPERACAO_DECOLAGEM, 0.0, HUGE_VAL, 40.0);
+    registrar_chegada(OPERACAO_POUSO, 0.0, LIMIAR_URGENCIA + 5.0, 2.0);
+    VERIFICAR(panes_secas_replay(1) == panes_secas_replay(0), "EDF antecipou um pouso fora do limiar");
+
+    // Pedidos ainda não chegados não são atendidos antes da hora
+    reiniciar_sequenciador();
+    registrar_chegada(OPERACAO_POUSO, 50.0, 51.0, 2.0);
+    VERIFICAR(panes_secas_replay(0) == 0, "pouso atendido antes de chegar contou pane");
+}
+
+// ========== HERANÇA DE PRIORIDADE ==========
+
+static aviao_t* preparar_detentor(int indice, tipo_voo_t tipo, recurso_t detido, int aguardado) {
+    aviao_t* aviao = &avioes[indice];
+    memset(aviao, 0, sizeof(aviao_t));
+    aviao->id = indice + 1;
+    aviao->tipo = tipo;
+    aviao->estado = ESPERANDO_DECOLAGEM;
+    aviao->recursos_detidos = 1 << detido;
+    aviao->recurso_aguardado = aguardado;
+    return aviao;
+}
+
+static void testar_propagar_heranca() {
+    prioridade_edf = 0;
+    heranca_prioridade = 1;
+    memset(&stats, 0, sizeof(stats));
+    NUM_PISTAS = 1;
+    NUM_PORTOES = 1;
+    MAX_TORRE_OPERACOES = 1;
+    pistas_em_uso = 1;
+    portoes_em_uso = 0;
+    torre_operacoes_ativas = 1;
+
+    // Doméstico A com a torre aguardando a pista, retida pelo doméstico B que aguarda portão
+    aviao_t* a = preparar_detentor(0, VOO_DOMESTICO, RECURSO_TORRE, RECURSO_PISTA);
+    aviao_t* b = preparar_detentor(1, VOO_DOMESTICO, RECURSO_PISTA, RECURSO_PORTAO);
+    aviao_t* c = preparar_detentor(2, VOO_DOMESTICO, RECURSO_PISTA, -1); // Parado fora de uma espera
+    contador_avioes = 3;
+
+    // Um internacional aguarda a torre esgotada: A herda e passa a herança a B pela cadeia de esperas
+    pthread_mutex_lock(&mutex_estatisticas);
+    propagar_heranca(RECURSO_TORRE, PRIORIDADE_INTERNACIONAL, 0);
+    pthread_mutex_unlock(&mutex_estatisticas);
+    VERIFICAR(prioridade_efetiva(a) == PRIORIDADE_INTERNACIONAL && prioridade_elevada(a), "A não herdou");
+    VERIFICAR(prioridade_efetiva(b) == PRIORIDADE_INTERNACIONAL, "B não herdou pela cadeia");
+    VERIFICAR(!prioridade_elevada(c), "detentor fora de uma espera foi elevado");
+    VERIFICAR(stats.inversoes_prioridade == 2 && stats.herancas_transitivas == 1,
+              "%d inversões, %d transitivas", stats.inversoes_prioridade, stats.herancas_transitivas);
+
+    // A mesma espera refeita não conta de novo; a herança só vale com a opção ativa
+    pthread_mutex_lock(&mutex_estatisticas);
+    propagar_heranca(RECURSO_TORRE, PRIORIDADE_INTERNACIONAL, 0);
+    pthread_mutex_unlock(&mutex_estatisticas);
+    VERIFICAR(stats.inversoes_prioridade == 2 && stats.herancas_transitivas == 1, "nova tentativa contada");
+    heranca_prioridade = 0;
+    VERIFICAR(!prioridade_elevada(a), "herança elevou com a opção desativada");
+    heranca_prioridade = 1;
+
+    // Liberar o recurso que motivou a herança a encerra; outro recurso não
+    pthread_mutex_lock(&mutex_estatisticas);
+    encerrar_heranca(a, RECURSO_PISTA);
+    VERIFICAR(prioridade_elevada(a), "herança encerrada pelo recurso errado");
+    encerrar_heranca(a, RECURSO_TORRE);
+    pthread_mutex_unlock(&mutex_estatisticas);
+    VERIFICAR(!prioridade_elevada(a) && stats.inversoes_encerradas == 1, "herança de A não encerrada");
+
+    // Com unidade livre a espera não é culpa dos detentores
+    torre_operacoes_ativas = 0;
+    a = preparar_detentor(0, VOO_DOMESTICO, RECURSO_TORRE, RECURSO_PISTA);
+    pthread_mutex_lock(&mutex_estatisticas);
+    propagar_heranca(RECURSO_TORRE, PRIORIDADE_INTERNACIONAL, 0);
+    pthread_mutex_unlock(&mutex_estatisticas);
+    VERIFICAR(!prioridade_elevada(a), "herança com a torre livre");
+
+    contador_avioes = 0;
+    pistas_em_uso = 0;
+}
+
+// ========== MALHA DE TAXIAMENTO ==========
+
+static void testar_rotas_malha() {
+    // O caminho direto P-A-G (200 m) perde para P-B-C-G (150 m), com mais segmentos
+    int resultado = carregar_de_texto(carregar_malha_taxi,
+        "segmento P A 100\n"
+        "segmento A G 100\n"
+        "segmento P B 50\n"
+        "segmento B C 50\n"
+        "segmento C G 50\n"
+        "segmento R A 10\n"
+        "pista 1 P\n"
+        "pista 3 C   # a pista 2 herda a cabeceira da 1\n"
+        "portao 1 G\n"
+        "remota R\n");
+    VERIFICAR(resultado == 0 && malha_ativa, "malha válida rejeitada");
+    if (resultado != 0) return;
+
+    int p = no_da_malha("P", 0), g = no_da_malha("G", 0), r = no_da_malha("R", 0), c = no_da_malha("C", 0);
+    VERIFICAR(malha.num_nos == 6 && malha.num_segmentos == 6, "%d nós, %d segmentos", malha.num_nos, malha.num_segmentos);
+    VERIFICAR(malha.num_nos_pista == 3 && malha.nos_pista[1] == p && malha.nos_pista[2] == c,
+              "pista sem declaração não herdou a primeira cabeceira");
+    VERIFICAR(distancia_rota(p, g) == 150.0 && distancia_rota(g, p) == 150.0,
+              "rota P↔G de %.0f/%.0f m, esperado 150", distancia_rota(p, g), distancia_rota(g, p));
+    VERIFICAR(distancia_rota(r, c) == 160.0, "rota R→C de %.0f m, esperado 160 (R-A-G-C)", distancia_rota(r, c));
+    VERIFICAR(distancia_rota(p, p) == 0.0, "rota de um nó para ele mesmo");
+
+    int rota[MAX_NOS_MALHA];
+    int n = montar_rota(p, g, rota);
+    VERIFICAR(n == 3, "rota P→G com %d segmentos, esperado 3", n);
+    for (int i = 0, u = p; i < n; i++) {
+        VERIFICAR(malha.segmentos[rota[i]].extremos[0] == u || malha.segmentos[rota[i]].extremos[1] == u,
+                  "segmento %d da rota não parte do nó anterior", i);
+        u = outro_extremo(rota[i], u);
+        if (i == n - 1) VERIFICAR(u == g, "rota não termina no portão");
+    }
+    VERIFICAR(malha.maior_rota >= n, "maior_rota %d menor que uma rota de %d segmentos", malha.maior_rota, n);
+
+    // Desconexões: pista sem portão e posição remota sem pista
+    VERIFICAR(carregar_de_texto(carregar_malha_taxi,
+                  "segmento P A 100\nsegmento G H 100\npista 1 P\nportao 1 G\n") != 0,
+              "pista sem rota até o portão aceita");
+    VERIFICAR(carregar_de_texto(carregar_malha_taxi,
+                  "segmento P G 100\nsegmento R S 10\npista 1 P\nportao 1 G\nremota R\n") != 0,
+              "posição remota sem rota até a pista aceita");
+    VERIFICAR(carregar_de_texto(carregar_malha_taxi, "segmento P G 100\npista 1 P\n") != 0,
+              "malha sem portão aceita");
+
+    // As falhas de carga ficam em aeroporto_erro(), sem sair do processo
+    VERIFICAR(strstr(aeroporto_erro(), "portão") != NULL, "motivo da falha: \"%s\"", aeroporto_erro());
+    VERIFICAR(carregar_malha_taxi("testes/inexistente.txt") != 0 && strstr(aeroporto_erro(), "inexistente.txt") != NULL,
+              "motivo da falha ao abrir: \"%s\"", aeroporto_erro());
+    liberar_malha_taxi();
+}
+
+// ========== TERMINAL DE PASSAGEIROS ==========
+
+static void injetar_passageiro(int i, int ficha, float bagagem_em) {
+    terminal.fase[i] = PAX_CAMINHANDO;
+    terminal.ficha[i] = ficha;
+    terminal.criado[i] = 0;
+    terminal.chegada_fila[i] = CAMINHADA_IMIGRACAO;
+    terminal.servico[i] = 0.5f;
+    terminal.bagagem_em[i] = bagagem_em;
+    terminal.ativos++;
+}
+
+static void testar_avancar_passageiros() {
+    // Dois internacionais sem bagagem e um doméstico com a mala em 5 s, com um só balcão
+    reiniciar_terminal();
+    num_balcoes_imigracao = 1;
+    injetar_passageiro(0, 0, 0);
+    injetar_passageiro(1, 1, 0);
+    injetar_passageiro(2, -1, 5.0f);
+    terminal.fichas_emitidas = 2;
+    terminal.alto = LANES_PASSAGEIROS;
+
+    avancar_passageiros(1.0f);
+    VERIFICAR(terminal.ativos == 3 && terminal.no_salao == 2, "%d ativos, %d no salão", terminal.ativos, terminal.no_salao);
+
+    // Na chegada os internacionais entram na fila e a primeira ficha é chamada; o doméstico vai à bagagem
+    avancar_passageiros(CAMINHADA_IMIGRACAO);
+    VERIFICAR(terminal.fase[0] == PAX_FILA && terminal.fase[1] == PAX_FILA && terminal.fase[2] == PAX_BAGAGEM,
+              "fases %d/%d/%d após a caminhada", terminal.fase[0], terminal.fase[1], terminal.fase[2]);
+    VERIFICAR(terminal.fichas_chamadas == 1 && terminal.balcoes_ocupados == 1, "%d fichas chamadas, %d balcões",
+              terminal.fichas_chamadas, terminal.balcoes_ocupados);
+
+    // Só a ficha chamada vai ao balcão; a seguinte espera o balcão liberar
+    avancar_passageiros(2.5f);
+    VERIFICAR(terminal.fase[0] == PAX_BALCAO && terminal.fase[1] == PAX_FILA, "fila fora da ordem das fichas");
+    VERIFICAR(terminal.fim_balcao[0] == 3.0f && terminal.no_salao == 1, "fim do balcão %.2f, %d no salão",
+              terminal.fim_balcao[0], terminal.no_salao);
+    avancar_passageiros(3.0f);
+    VERIFICAR(terminal.fase[0] == PAX_BAGAGEM && terminal.fichas_chamadas == 2 && terminal.balcoes_ocupados == 1,
+              "balcão liberado não chamou a próxima ficha");
+
+    for (float agora = 3.5f; agora <= 5.0f; agora += 0.5f) {
+        avancar_passageiros(agora);
+    }
+    VERIFICAR(terminal.ativos == 0 && terminal.balcoes_ocupados == 0 && terminal.atendimentos == 2,
+              "%d ativos, %d balcões ocupados, %lld atendimentos", terminal.ativos, terminal.balcoes_ocupados,
+              terminal.atendimentos);
+    VERIFICAR(terminal.saidas == 3 && terminal.saidas_internacionais == 2, "%lld saídas, %lld internacionais",
+              terminal.saidas, terminal.saidas_internacionais);
+    VERIFICAR(perto(terminal.permanencia_total, 3.5 + 4.5 + 5.0, 1e-4) &&
+              perto(terminal.permanencia_internacional, 3.5 + 4.5, 1e-4),
+              "permanência %.2f s (internacional %.2f s)", terminal.permanencia_total, terminal.permanencia_internacional);
+    VERIFICAR(perto(terminal.espera_imigracao_total, 0.5 + 1.5, 1e-4), "espera na imigração %.2f s",
+              terminal.espera_imigracao_total);
+    VERIFICAR(terminal.passos == 8 && terminal.agentes_processados == 8 * LANES_PASSAGEIROS,
+              "%lld passos, %lld agentes", terminal.passos, terminal.agentes_processados);
+
+    // O salão lotado barra novos internacionais na admissão
+    aviao_t internacional = { .tipo = VOO_INTERNACIONAL };
+    float servico[3] = { 0.5f, 0.5f, 0.5f }, bagagem[3] = { 0, 0, 0 };
+    reiniciar_terminal();
+    capacidade_salao_imigracao = 2;
+    inicio_simulacao = agora_ns();
+    VERIFICAR(admitir_passageiros(&internacional, 3, servico, bagagem) == 2 && terminal.no_salao == 2,
+              "admissão ignorou a capacidade do salão");
+    capacidade_salao_imigracao = 600;
+    num_balcoes_imigracao = 10;
+    reiniciar_terminal();
+}
+
+int main() {
+    testar_percentil_espera();
+    testar_truncamento_mser5();
+    testar_meia_largura_lotes();
+    testar_eventos_capacidade();
+    testar_separacao_minima();
+    testar_despachar_pistas();
+    testar_panes_secas_replay();
+    testar_propagar_heranca();
+    testar_rotas_malha();
+    testar_avancar_passageiros();
+
+    if (falhas > 0) {
+        printf("✗ %d verificações falharam\n", falhas);
+        return 1;
+    }
+    printf("✓ Testes de unidade do simulador passaram\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Testes da redução do ex1: divisão em blocos, divisão adaptativa e roubo de tarefas nas deques, e a
+// soma de parallel_reduce com divisão estática e com roubo de trabalho. Inclui ex1.c com o main
+// renomeado para alcançar as funções internas.
+
+#define main ex1_main
+#include "ex1.c"
+#undef main
+
+static int failures = 0;
+
+#define CHECK(condition, ...) do {                     \
+    if (!(condition)) {                                \
+        printf("✗ %s:%d: ", __FILE__, __LINE__);        \
+        printf(__VA_ARGS__);                           \
+        printf("\n");                                  \
+        failures++;                                    \
+    }                                                  \
+} while (0)
+
+// ========== BLOCOS ==========
+
+static void test_chunk_bounds(void) {
+    long start, end;
+    chunk_bounds(100, 3, 0, &start, &end);
+    CHECK(start == 0 && end == 32, "bloco 0: %ld..%ld", start, end);
+    chunk_bounds(100, 3, 2, &start, &end);
+    CHECK(start == 66 && end == 99, "bloco 2: %ld..%ld", start, end);
+    chunk_bounds(3, 4, 0, &start, &end);
+    CHECK(end < start, "com mais threads que elementos o primeiro bloco deveria ficar vazio");
+}
+
+// ========== DEQUES E ROUBO ==========
+
+static void test_split_and_steal(void) {
+    long size = 8 * MIN_GRAIN;
+    long *data = malloc(size * sizeof(long));
+    for (long i = 0; i < size; i++) {
+        data[i] = i;
+    }
+    task_deque_t deques[2];
+    reduce_job_t job = { .data = data, .size = size, .num_threads = 2, .kernel = sum_scalar,
+                         .deques = deques, .grain = MIN_GRAIN };
+    atomic_init(&job.remaining, size);
+    atomic_init(&job.idle, 1);                                          // Alguém ocioso: há demanda para dividir
+    for (int i = 0; i < 2; i++) {
+        pthread_mutex_init(&deques[i].lock, NULL);
+        deques[i].top = deques[i].bottom = 0;
+    }
+    reduce_worker_t owner = { .job = &job, .thread_id = 0 };
+    reduce_worker_t thief = { .job = &job, .thread_id = 1, .rng = 12345 };
+
+    // Com demanda, a metade de cima vai para a deque até sobrar um grão: [4g,8g), [2g,4g), [g,2g)
+    long sum = run_task(&owner, (task_t){ 0, size });
+    long grain = MIN_GRAIN;
+    CHECK(sum == grain * (grain - 1) / 2, "soma do primeiro grão: %ld", sum);
+    CHECK(owner.elements == grain, "%ld elementos reduzidos, esperado %ld", owner.elements, grain);
+    CHECK(deques[0].bottom - deques[0].top == 3, "%d tarefas na deque, esperado 3",
+          deques[0].bottom - deques[0].top);
+    CHECK(atomic_load(&job.remaining) == size - grain, "remaining %ld", atomic_load(&job.remaining));
+
+    // O ladrão leva a tarefa mais antiga (a maior); o dono desempilha a mais recente
+    task_t task;
+    CHECK(steal_task(&thief, &task) && task.begin == 4 * grain && task.end == size,
+          "roubou [%ld, %ld), esperado [%ld, %ld)", task.begin, task.end, 4 * grain, size);
+    CHECK(thief.steals == 1, "%ld roubos contados", thief.steals);
+    CHECK(deque_pop(&deques[0], &task) && task.begin == grain && task.end == 2 * grain,
+          "desempilhou [%ld, %ld), esperado [%ld, %ld)", task.begin, task.end, grain, 2 * grain);
+    CHECK(!steal_task(&owner, &task), "o dono roubou da própria deque");
+
+    // Sem demanda e com tarefas na deque, o dono processa grão a grão sem dividir
+    atomic_store(&job.idle, 0);
+    owner.elements = 0;
+    sum = run_task(&owner, (task_t){ 2 * grain, 4 * grain });
+    CHECK(sum == (6 * grain - 1) * (2 * grain) / 2, "soma de [2g, 4g): %ld", sum);
+    CHECK(owner.elements == 2 * grain && deques[0].bottom - deques[0].top == 1, "dividiu sem demanda");
+
+    for (int i = 0; i < 2; i++) {
+        pthread_mutex_destroy(&deques[i].lock);
+    }
+    free(data);
+}
+
+// ========== REDUÇÃO COMPLETA ==========
+
+static void test_parallel_reduce(void) {
+    static const long sizes[] = { 3, 100, 100003, 1L << 20 };
+    static const int thread_counts[] = { 2, 3, 8 };
+    long largest = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    long *data = malloc(largest * sizeof(long));
+    reduce_worker_t workers[8];
+    for (long i = 0; i < largest; i++) {
+        data[i] = i;
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+            long size = sizes[s];
+            int threads = thread_counts[t];
+            long expected = size * (size - 1) / 2;
+            for (int schedule = SCHEDULE_STATIC; schedule <= SCHEDULE_STEALING; schedule++) {
+                long total = parallel_reduce(data, size, threads, sum_scalar, (schedule_t)schedule, workers);
+                long elements = 0;
+                for (int i = 0; i < threads; i++) {
+                    elements += workers[i].elements;
+                }
+                CHECK(total == expected, "%s, %ld elementos, %d threads: %ld, esperado %ld",
+                      schedule == SCHEDULE_STEALING ? "roubo" : "estática", size, threads, total, expected);
+                CHECK(elements == size, "%ld elementos reduzidos de %ld", elements, size);
+            }
+        }
+    }
+
+    // Custo desigual: o roubo redistribui o trabalho sem mudar o resultado
+    long size = 1L << 18;
+    long reference = parallel_reduce(data, size, 4, skew_kernel, SCHEDULE_STATIC, NULL);
+    long stolen = parallel_reduce(data, size, 4, skew_kernel, SCHEDULE_STEALING, workers);
+    CHECK(stolen == reference, "skew com roubo: %ld, estática: %ld", stolen, reference);
+    CHECK(parallel_reduce(data, size, 4, select_sum_kernel(), SCHEDULE_STEALING, NULL) == size * (size - 1) / 2,
+          "kernel de soma selecionado em tempo de execução");
+
+    free(data);
+}
+
+int main(void) {
+    test_chunk_bounds();
+    test_split_and_steal();
+    test_parallel_reduce();
+
+    if (failures > 0) {
+        printf("✗ %d verificações falharam\n", failures);
+        return 1;
+    }
+    printf("✓ Testes da redução do ex1 passaram\n");
+    return 0;
+}
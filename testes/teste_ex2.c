@@ -0,0 +1,146 @@
+/*
+ * Testes da fila MPMC do ex2: reserva de lotes (parcial quando a fila
+ * enche ou esvazia, volta do anel) e entrega sem perdas nem duplicatas
+ * com produtores e consumidores concorrentes. Inclui ex2.c com o main
+ * renomeado para alcançar as funções da fila.
+ */
+#define main ex2_main
+#include "ex2.c"
+#undef main
+
+static int falhas = 0;
+
+#define VERIFICAR(condicao, ...) do {            \
+    if (!(condicao)) {                           \
+      printf("✗ %s:%d: ", __FILE__, __LINE__);   \
+      printf(__VA_ARGS__);                       \
+      printf("\n");                              \
+      falhas++;                                  \
+    }                                            \
+  } while (0)
+
+/* ---------------- Lotes numa só thread ---------------- */
+
+static void testar_lotes(void) {
+  fila_t f;
+  int entrada[10], saida[10];
+  size_t i, k;
+
+  VERIFICAR(capacidade_fila(1) == 2, "capacidade mínima %zu", capacidade_fila(1));
+  VERIFICAR(capacidade_fila(32) == 32 && capacidade_fila(33) == 64,
+            "capacidade não arredondada para potência de 2");
+
+  for (i = 0; i < 10; i++)
+    entrada[i] = (int)i;
+  fila_init(&f, 4);
+
+  /* O lote maior que a fila reserva só as posições livres */
+  k = fila_tenta_inserir_lote(&f, entrada, 10);
+  VERIFICAR(k == 4, "inseriu %zu de 10 numa fila de 4", k);
+  VERIFICAR(fila_tenta_inserir_lote(&f, entrada, 1) == 0, "inseriu com a fila cheia");
+
+  k = fila_tenta_remover_lote(&f, saida, 3);
+  VERIFICAR(k == 3 && saida[0] == 0 && saida[1] == 1 && saida[2] == 2,
+            "remoção parcial fora de ordem");
+
+  /* Volta do anel: as 3 posições liberadas recebem o próximo lote */
+  k = fila_tenta_inserir_lote(&f, entrada + 4, 5);
+  VERIFICAR(k == 3, "inseriu %zu de 5 com 3 posições livres", k);
+  k = fila_tenta_remover_lote(&f, saida, 10);
+  VERIFICAR(k == 4, "removeu %zu de 4", k);
+  for (i = 0; i < k; i++)
+    VERIFICAR(saida[i] == (int)(i + 3), "posição %zu: %d, esperado %zu", i, saida[i], i + 3);
+  VERIFICAR(fila_tenta_remover_lote(&f, saida, 1) == 0, "removeu com a fila vazia");
+
+  fila_destroy(&f);
+}
+
+/* ---------------- Produtores e consumidores concorrentes ---------------- */
+
+#define PRODUTORES_TESTE 4
+#define CONSUMIDORES_TESTE 3
+#define ITENS_POR_PRODUTOR 50000
+#define LOTE_PRODUTOR 7
+#define LOTE_CONSUMIDOR 5
+
+static fila_t fila_teste;
+static atomic_int recebidos[PRODUTORES_TESTE * ITENS_POR_PRODUTOR];
+static int fora_de_ordem[CONSUMIDORES_TESTE];
+
+static void* produtor_teste(void *v) {
+  int p = (int)(intptr_t)v;
+  int lote[LOTE_PRODUTOR];
+  int i, j;
+
+  for (i = 0; i < ITENS_POR_PRODUTOR; i += j) {
+    for (j = 0; j < LOTE_PRODUTOR && i + j < ITENS_POR_PRODUTOR; j++)
+      lote[j] = p * ITENS_POR_PRODUTOR + i + j;
+    fila_inserir_lote(&fila_teste, lote, j);
+  }
+  return NULL;
+}
+
+/* Cada consumidor retira sua cota; os itens de um mesmo produtor devem
+ * chegar a ele em ordem crescente, já que a fila é FIFO */
+static void* consumidor_teste(void *v) {
+  int c = (int)(intptr_t)v;
+  int total = PRODUTORES_TESTE * ITENS_POR_PRODUTOR;
+  int cota = total / CONSUMIDORES_TESTE + (c < total % CONSUMIDORES_TESTE);
+  int ultimo[PRODUTORES_TESTE];
+  int lote[LOTE_CONSUMIDOR];
+  int obtidos, quero;
+  size_t k, j;
+
+  for (j = 0; j < PRODUTORES_TESTE; j++)
+    ultimo[j] = -1;
+  for (obtidos = 0; obtidos < cota; obtidos += (int)k) {
+    quero = cota - obtidos < LOTE_CONSUMIDOR ? cota - obtidos : LOTE_CONSUMIDOR;
+    k = fila_remover_lote(&fila_teste, lote, quero);
+    for (j = 0; j < k; j++) {
+      int p = lote[j] / ITENS_POR_PRODUTOR;
+
+      atomic_fetch_add(&recebidos[lote[j]], 1);
+      if (lote[j] <= ultimo[p])
+        fora_de_ordem[c]++;
+      ultimo[p] = lote[j];
+    }
+  }
+  return NULL;
+}
+
+static void testar_concorrencia(void) {
+  pthread_t produtores[PRODUTORES_TESTE], consumidores[CONSUMIDORES_TESTE];
+  int i, perdidos = 0, duplicados = 0;
+
+  fila_init(&fila_teste, 8);  /* Pequena: força voltas do anel e esperas */
+  for (i = 0; i < CONSUMIDORES_TESTE; i++)
+    pthread_create(&consumidores[i], NULL, consumidor_teste, (void*)(intptr_t)i);
+  for (i = 0; i < PRODUTORES_TESTE; i++)
+    pthread_create(&produtores[i], NULL, produtor_teste, (void*)(intptr_t)i);
+  for (i = 0; i < PRODUTORES_TESTE; i++)
+    pthread_join(produtores[i], NULL);
+  for (i = 0; i < CONSUMIDORES_TESTE; i++)
+    pthread_join(consumidores[i], NULL);
+
+  for (i = 0; i < PRODUTORES_TESTE * ITENS_POR_PRODUTOR; i++) {
+    perdidos += atomic_load(&recebidos[i]) == 0;
+    duplicados += atomic_load(&recebidos[i]) > 1;
+  }
+  VERIFICAR(perdidos == 0 && duplicados == 0, "%d itens perdidos, %d duplicados", perdidos, duplicados);
+  for (i = 0; i < CONSUMIDORES_TESTE; i++)
+    VERIFICAR(fora_de_ordem[i] == 0, "consumidor %d recebeu %d itens fora de ordem", i, fora_de_ordem[i]);
+  VERIFICAR(fila_tenta_remover_lote(&fila_teste, (int[1]){0}, 1) == 0, "sobrou item na fila");
+  fila_destroy(&fila_teste);
+}
+
+int main(void) {
+  testar_lotes();
+  testar_concorrencia();
+
+  if (falhas > 0) {
+    printf("✗ %d verificações falharam\n", falhas);
+    return 1;
+  }
+  printf("✓ Testes da fila do ex2 passaram\n");
+  return 0;
+}